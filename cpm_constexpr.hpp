@@ -0,0 +1,162 @@
+// CPM em tempo de compilação para modelos de projeto fixos
+// Cabeçalho independente de main.cpp, para embutir em outros programas (C++17);
+// main.cpp o inclui e confere com static_assert que ele segue as mesmas regras.
+//
+// Mesma regra de calcularPERT/encontrarCaminhoCritico de main.cpp, sobre std::array:
+// o cronograma de um modelo conhecido na compilação vira constante, e ciclos podem
+// ser barrados com static_assert. Exemplo:
+//
+//   constexpr ModeloFixo<int, 4, 4> lancamento{
+//       {3, 2, 4, 1},                              // durações
+//       {{{0, 1}, {0, 2}, {1, 3}, {2, 3}}}};       // (predecessor, sucessor)
+//   static_assert(aciclico(lancamento));
+//   constexpr auto base = calcularPERTFixo(lancamento);
+//   static_assert(base.duracao == 8);
+//   auto cron = base.deslocado(inicioDoProjeto);   // por execução: só somas
+//
+// Modelos grandes podem exigir -fconstexpr-ops-limit / -fconstexpr-loop-limit.
+
+#ifndef CPM_CONSTEXPR_HPP
+#define CPM_CONSTEXPR_HPP
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+template <class T, std::size_t N, std::size_t M>
+struct ModeloFixo {
+    std::array<T, N> dur;
+    std::array<std::pair<std::size_t, std::size_t>, M> arestas;   // (predecessor, sucessor)
+};
+
+template <class T, std::size_t N>
+struct CronogramaFixo {
+    bool ok = false;                  // falso se houver ciclo ou aresta fora de [0, N)
+    std::array<std::size_t, N> ordem{};   // ordem topológica
+    std::array<T, N> ES{}, EF{}, LS{}, LF{};
+    T duracao{};
+    std::array<std::size_t, N> caminho{};   // um caminho crítico, caminho[0 .. tamCaminho)
+    std::size_t tamCaminho = 0;
+
+    constexpr T folga(std::size_t i) const { return LS[i] - ES[i]; }
+    constexpr bool critica(std::size_t i) const { return LS[i] == ES[i]; }
+
+    // Mesmo cronograma começando em 'inicio' em vez de 0.
+    constexpr CronogramaFixo deslocado(T inicio) const {
+        CronogramaFixo c = *this;
+        for (std::size_t i = 0; i < N; i++) {
+            c.ES[i] = ES[i] + inicio;
+            c.EF[i] = EF[i] + inicio;
+            c.LS[i] = LS[i] + inicio;
+            c.LF[i] = LF[i] + inicio;
+        }
+        c.duracao = duracao;
+        return c;
+    }
+};
+
+// Listas de predecessores e sucessores (CSR) do modelo; sucessores em ordem crescente,
+// como as listas de main.cpp, para o caminho crítico sair igual.
+template <std::size_t N, std::size_t M>
+struct ListasFixas {
+    bool ok = true;
+    std::array<std::size_t, N + 1> predInicio{}, sucInicio{};
+    std::array<std::size_t, M> predAlvo{}, sucAlvo{};
+};
+
+template <class T, std::size_t N, std::size_t M>
+constexpr ListasFixas<N, M> construirListasFixas(const ModeloFixo<T, N, M>& m) {
+    ListasFixas<N, M> l;
+    for (std::size_t k = 0; k < M; k++) {
+        if (m.arestas[k].first >= N || m.arestas[k].second >= N) {
+            l.ok = false;
+            return l;
+        }
+        l.predInicio[m.arestas[k].second + 1]++;
+        l.sucInicio[m.arestas[k].first + 1]++;
+    }
+    for (std::size_t v = 0; v < N; v++) {
+        l.predInicio[v + 1] += l.predInicio[v];
+        l.sucInicio[v + 1] += l.sucInicio[v];
+    }
+    std::array<std::size_t, N + 1> pos{};
+    for (std::size_t v = 0; v <= N; v++) pos[v] = l.predInicio[v];
+    for (std::size_t k = 0; k < M; k++) l.predAlvo[pos[m.arestas[k].second]++] = m.arestas[k].first;
+    // transposta percorrendo v em ordem crescente: cada lista de sucessores sai ordenada
+    for (std::size_t v = 0; v <= N; v++) pos[v] = l.sucInicio[v];
+    for (std::size_t v = 0; v < N; v++)
+        for (std::size_t k = l.predInicio[v]; k < l.predInicio[v + 1]; k++) l.sucAlvo[pos[l.predAlvo[k]]++] = v;
+    return l;
+}
+
+// Kahn; retorna false se houver ciclo.
+template <std::size_t N, std::size_t M>
+constexpr bool topoOrdenacaoFixa(const ListasFixas<N, M>& l, std::array<std::size_t, N>& ordem) {
+    std::array<std::size_t, N> indeg{};
+    for (std::size_t v = 0; v < N; v++) indeg[v] = l.predInicio[v + 1] - l.predInicio[v];
+    std::size_t fim = 0;
+    for (std::size_t v = 0; v < N; v++) if (indeg[v] == 0) ordem[fim++] = v;
+    for (std::size_t h = 0; h < fim; h++) {
+        std::size_t u = ordem[h];
+        for (std::size_t k = l.sucInicio[u]; k < l.sucInicio[u + 1]; k++)
+            if (--indeg[l.sucAlvo[k]] == 0) ordem[fim++] = l.sucAlvo[k];
+    }
+    return fim == N;
+}
+
+template <class T, std::size_t N, std::size_t M>
+constexpr bool aciclico(const ModeloFixo<T, N, M>& m) {
+    ListasFixas<N, M> l = construirListasFixas(m);
+    std::array<std::size_t, N> ordem{};
+    return l.ok && topoOrdenacaoFixa(l, ordem);
+}
+
+template <class T, std::size_t N, std::size_t M>
+constexpr CronogramaFixo<T, N> calcularPERTFixo(const ModeloFixo<T, N, M>& m) {
+    CronogramaFixo<T, N> c;
+    ListasFixas<N, M> l = construirListasFixas(m);
+    if (!l.ok || !topoOrdenacaoFixa(l, c.ordem)) return c;
+
+    // -------- forward (ES/EF) --------
+    for (std::size_t h = 0; h < N; h++) {
+        std::size_t u = c.ordem[h];
+        T maxEfPred{};
+        for (std::size_t k = l.predInicio[u]; k < l.predInicio[u + 1]; k++)
+            if (c.EF[l.predAlvo[k]] > maxEfPred) maxEfPred = c.EF[l.predAlvo[k]];
+        c.ES[u] = maxEfPred;
+        c.EF[u] = c.ES[u] + m.dur[u];
+        if (c.EF[u] > c.duracao) c.duracao = c.EF[u];
+    }
+
+    // -------- backward (LS/LF) --------
+    for (std::size_t h = N; h-- > 0;) {
+        std::size_t u = c.ordem[h];
+        c.LF[u] = c.duracao;   // sem sucessores fica no fim do projeto
+        for (std::size_t k = l.sucInicio[u]; k < l.sucInicio[u + 1]; k++) {
+            std::size_t v = l.sucAlvo[k];
+            if (k == l.sucInicio[u] || c.LS[v] < c.LF[u]) c.LF[u] = c.LS[v];
+        }
+        c.LS[u] = c.LF[u] - m.dur[u];
+    }
+
+    // -------- um caminho crítico --------
+    // começa pela primeira atividade crítica sem predecessores; na falta, pela primeira crítica
+    std::size_t inicio = N;
+    for (std::size_t i = 0; i < N && inicio == N; i++)
+        if (l.predInicio[i] == l.predInicio[i + 1] && c.critica(i)) inicio = i;
+    for (std::size_t i = 0; i < N && inicio == N; i++)
+        if (c.critica(i)) inicio = i;
+    for (std::size_t cur = inicio; cur != N;) {
+        c.caminho[c.tamCaminho++] = cur;
+        std::size_t proximo = N;
+        for (std::size_t k = l.sucInicio[cur]; k < l.sucInicio[cur + 1] && proximo == N; k++) {
+            std::size_t v = l.sucAlvo[k];
+            if (c.critica(v) && c.ES[v] == c.EF[cur]) proximo = v;
+        }
+        cur = proximo;
+    }
+    c.ok = true;
+    return c;
+}
+
+#endif
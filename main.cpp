@@ -1,346 +1,7216 @@
 // Alunos: Pedro Schneider, Isadora e Kirsten Luz
-// Compilação: g++ -o main main.cpp
+// Compilação: g++ -O2 -pthread -o main main.cpp
 
 #include <iostream>
 #include <vector>
 #include <string>
-#include <sstream>
 #include <limits>
 #include <queue>
 #include <algorithm>
+#include <atomic>
+#include <numeric>
 #include <fstream>
+#include <sstream>
 #include <iomanip>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+#include <array>
+#include <new>
+#include <utility>
+#include <cstdlib>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "cpm_constexpr.hpp"
 using namespace std;
 
-inline int** criarMatriz(int qntV) {
-    int** mat = new int*[qntV];
-    for (int i = 0; i < qntV; i++) {
-        mat[i] = new int[qntV](); 
+// ---------------- topologia NUMA e execução paralela ----------------
+// Lista no formato do kernel ("0-3,8,10-11"), usada para nós e CPUs.
+vector<int> lerListaNumeros(const string& s) {
+    vector<int> r;
+    const char* p = s.c_str();
+    while (*p) {
+        char* fim;
+        long a = strtol(p, &fim, 10), b = a;
+        if (fim == p) break;
+        p = fim;
+        if (*p == '-') { b = strtol(p + 1, &fim, 10); p = fim; }
+        for (long c = a; c <= b; c++) r.push_back((int)c);
+        if (*p != ',') break;
+        p++;
     }
-    return mat;
+    return r;
 }
-inline void liberarMatriz(int** mat, int qntV) {
-    for (int i = 0; i < qntV; i++) delete[] mat[i];
-    delete[] mat;
+
+// Nós NUMA com CPUs, lidos de /sys/devices/system/node. Vazio fora do Linux ou sem
+// a informação, o que equivale a um nó só.
+struct TopologiaNUMA {
+    vector<vector<int>> cpus;    // CPUs de cada nó; nós só com memória ficam de fora
+    bool fixarThreads = false;   // paraleloBlocos prende a thread t ao nó t * nós / nt
+
+    size_t nos() const { return max<size_t>(1, cpus.size()); }
+
+    static TopologiaNUMA& instancia() {
+        static TopologiaNUMA t = [] {
+            TopologiaNUMA t;
+            ifstream online("/sys/devices/system/node/online");
+            string linha;
+            if (getline(online, linha))
+                for (int no : lerListaNumeros(linha)) {
+                    ifstream f("/sys/devices/system/node/node" + to_string(no) + "/cpulist");
+                    string l;
+                    if (!getline(f, l)) continue;
+                    vector<int> c = lerListaNumeros(l);
+                    if (!c.empty()) t.cpus.push_back(move(c));
+                }
+            return t;
+        }();
+        return t;
+    }
+
+    // Prende a thread que chama às CPUs do nó; false se não foi possível.
+    bool fixar(size_t no) const {
+#ifdef __linux__
+        if (no >= cpus.size()) return false;
+        cpu_set_t conj;
+        CPU_ZERO(&conj);
+        for (int c : cpus[no]) if (c < CPU_SETSIZE) CPU_SET(c, &conj);
+        return sched_setaffinity(0, sizeof(conj), &conj) == 0;
+#else
+        (void)no;
+        return false;
+#endif
+    }
+};
+
+// Threads de paraleloBlocos para n itens; o primeiro toque da arena usa a mesma conta.
+inline size_t threadsBlocos(size_t n, size_t minPorThread = 4096) {
+    size_t nt = max<size_t>(1, thread::hardware_concurrency());
+    return max<size_t>(1, min(nt, n / minPorThread));
 }
 
-// ---------------- buscar índice por rótulo ----------------
-int buscarIndice(const vector<string>& rotulos, const string& valor) {
-    for (int i = 0; i < (int)rotulos.size(); i++)
-        if (rotulos[i] == valor) return i;
-    return -1;
+// Divide [0, n) em blocos contíguos, um por thread; f(ini, fim, t) roda em cada um.
+// Com fixarThreads, blocos vizinhos ficam no mesmo nó: a thread t vai para o nó
+// t * nós / nt, a mesma divisão do primeiro toque da arena.
+template <class F>
+void paraleloBlocos(size_t n, F f, size_t minPorThread = 4096) {
+    size_t nt = threadsBlocos(n, minPorThread);
+    if (nt == 1) { f((size_t)0, n, (size_t)0); return; }
+    const TopologiaNUMA& topo = TopologiaNUMA::instancia();
+    bool fixar = topo.fixarThreads && topo.nos() > 1;
+    vector<thread> ths;
+    ths.reserve(nt);
+    for (size_t t = 0; t < nt; t++)
+        ths.emplace_back([&, t] {
+            if (fixar) topo.fixar(t * topo.nos() / nt);
+            f(n * t / nt, n * (t + 1) / nt, t);
+        });
+    for (auto& th : ths) th.join();
 }
 
-// ---------------- leitura de predecessores ----------------
-vector<int> lerPredecessores(const string& linha, const vector<string>& rotulos) {
-    vector<int> preds;
-    string s = linha;
-    if (s == "-") return preds;
-    stringstream ss(s);
-    string item;
-    while (getline(ss, item, ',')) {
-        int idx = buscarIndice(rotulos, item);
-        if (idx != -1) preds.push_back(idx);
-        else preds.push_back(-1); 
+// ---------------- arena monotônica ----------------
+// Política para os blocos grandes (>= 2 MB) da arena, onde moram CSR e ES/EF/LS/LF.
+// Padrão: operator new, como qualquer outro contêiner; as demais opções usam mmap.
+struct Posicionamento {
+    enum Paginas { NORMAIS, TRANSPARENTES, EXPLICITAS };
+    Paginas paginas = NORMAIS;   // TRANSPARENTES: madvise(MADV_HUGEPAGE); EXPLICITAS: MAP_HUGETLB
+    bool primeiroToque = false;  // bloco novo tocado em paralelo pelas threads de paraleloBlocos
+    bool ativo() const { return paginas != NORMAIS || primeiroToque; }
+};
+
+// Dona de toda a memória de uma execução: listas, rótulos, resultados e rascunhos.
+// Entrega blocos alinhados por incremento de ponteiro; desalocar é no-op e
+// reiniciar() devolve tudo de uma vez, mantendo os blocos já obtidos do sistema
+// para que a próxima execução reutilize memória quente sem tocar no malloc.
+// Contêineres pmr (Vetor, Rotulos) passam a usá-la recebendo &arena no construtor.
+class Arena : public pmr::memory_resource {
+public:
+    enum Origem { SISTEMA, MAPEADO, TRANSPARENTE, HUGETLB };   // de onde veio cada bloco
+
+    explicit Arena(size_t tamBloco = size_t(1) << 20, Posicionamento pos = {}) : tamBloco(tamBloco), pos(pos) {}
+    ~Arena() override {
+        for (auto& b : blocos) {
+#ifdef __linux__
+            if (b.origem != SISTEMA) { munmap(b.dados, b.tam); continue; }
+#endif
+            ::operator delete(b.dados, align_val_t(ALINHAMENTO_BLOCO));
+        }
     }
-    return preds;
-}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
 
-// ---------------- ordenação topológica (Kahn) ----------------
-// Se houver ciclo, retorna false.
-bool topoOrdenacao(int** mat, int qntV, vector<int>& ordem) {
-    vector<int> indeg(qntV, 0);
-    for (int i = 0; i < qntV; i++)
-        for (int j = 0; j < qntV; j++)
-            if (mat[i][j]) indeg[j]++;
-    queue<int> q;
-    for (int i = 0; i < qntV; i++) if (indeg[i] == 0) q.push(i);
-    while (!q.empty()) {
-        int u = q.front(); q.pop();
-        ordem.push_back(u);
-        for (int v = 0; v < qntV; v++) if (mat[u][v]) {
-            indeg[v]--;
-            if (indeg[v] == 0) q.push(v);
+    void reiniciar() {
+        atual = 0;
+        usado = 0;
+    }
+
+    // Vetor de n elementos triviais, zerado.
+    template <class T>
+    T* alocarVetor(size_t n) {
+        static_assert(is_trivially_destructible_v<T>, "arena não chama destrutores");
+        void* p = allocate(n * sizeof(T), alignof(T));
+        memset(p, 0, n * sizeof(T));
+        return static_cast<T*>(p);
+    }
+
+    size_t bytesReservados() const {
+        size_t t = 0;
+        for (auto& b : blocos) t += b.tam;
+        return t;
+    }
+    size_t bytesEmUso() const {
+        size_t t = 0;
+        for (size_t i = 0; i < atual && i < blocos.size(); i++) t += blocos[i].tam;
+        return t + usado;
+    }
+    size_t quantidadeBlocos() const { return blocos.size(); }
+    const Posicionamento& posicionamento() const { return pos; }
+    size_t bytesPorOrigem(Origem o) const {
+        size_t t = 0;
+        for (auto& b : blocos) if (b.origem == o) t += b.tam;
+        return t;
+    }
+
+    // Bytes residentes dos blocos mapeados em cada nó NUMA. move_pages sem destino
+    // só pergunta ao kernel onde está cada página; amostra até maxPaginas páginas.
+    // Vazio se o kernel não informar.
+    vector<size_t> bytesPorNo(size_t maxPaginas = size_t(1) << 16) const {
+        vector<size_t> r;
+#if defined(__linux__) && defined(SYS_move_pages)
+        size_t pag = (size_t)sysconf(_SC_PAGESIZE), total = 0;
+        for (auto& b : blocos) if (b.origem != SISTEMA) total += b.tam / pag;
+        size_t passo = max<size_t>(1, total / maxPaginas);
+        vector<void*> paginas;
+        for (auto& b : blocos)
+            if (b.origem != SISTEMA)
+                for (size_t i = 0; i < b.tam / pag; i += passo) paginas.push_back(b.dados + i * pag);
+        vector<int> no(paginas.size());
+        if (paginas.empty() || syscall(SYS_move_pages, 0, paginas.size(), paginas.data(), nullptr, no.data(), 0) != 0)
+            return r;
+        for (int x : no) {
+            if (x < 0) continue;   // página ainda não tocada
+            if ((size_t)x >= r.size()) r.resize(x + 1);
+            r[x] += passo * pag;
+        }
+#endif
+        return r;
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alinhamento) override {
+        for (; atual < blocos.size(); atual++, usado = 0) {
+            Bloco& b = blocos[atual];
+            uintptr_t base = (uintptr_t)b.dados;
+            uintptr_t ini = (base + usado + alinhamento - 1) & ~(uintptr_t)(alinhamento - 1);
+            if (ini + bytes <= base + b.tam) {
+                usado = ini + bytes - base;
+                return (void*)ini;
+            }
+        }
+        // blocos crescem em progressão geométrica (até 1024x) para poucas chamadas ao sistema
+        size_t tam = max(tamBloco << min<size_t>(blocos.size(), 10), bytes + alinhamento);
+        blocos.push_back(obterBloco(tam));
+        usado = 0;
+        void* p = do_allocate(bytes, alinhamento);
+        if (pos.primeiroToque && blocos.back().origem != SISTEMA) tocar(blocos.back(), bytes, alinhamento);
+        return p;
+    }
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const pmr::memory_resource& outro) const noexcept override { return this == &outro; }
+
+private:
+    static constexpr size_t ALINHAMENTO_BLOCO = 64;   // linha de cache
+    static constexpr size_t PAGINA_GRANDE = size_t(2) << 20;
+    struct Bloco {
+        char* dados;
+        size_t tam;
+        Origem origem;
+    };
+
+    Bloco obterBloco(size_t tam) {
+#ifdef __linux__
+        if (pos.ativo() && tam >= PAGINA_GRANDE) {
+            tam = (tam + PAGINA_GRANDE - 1) & ~(PAGINA_GRANDE - 1);
+            Bloco b{nullptr, tam, MAPEADO};
+            if (pos.paginas == Posicionamento::EXPLICITAS) {
+                // precisa de páginas reservadas (vm.nr_hugepages); sem elas, cai para as transparentes
+                void* p = mmap(nullptr, tam, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (p != MAP_FAILED) b = {(char*)p, tam, HUGETLB};
+            }
+            if (!b.dados) {
+                // 2 MB a mais para alinhar o início: o kernel só usa página grande em trecho alinhado
+                size_t total = tam + PAGINA_GRANDE;
+                void* m = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (m == MAP_FAILED) throw bad_alloc();
+                char* p = (char*)m;
+                char* ini = (char*)(((uintptr_t)p + PAGINA_GRANDE - 1) & ~(uintptr_t)(PAGINA_GRANDE - 1));
+                if (ini > p) munmap(p, ini - p);
+                munmap(ini + tam, p + total - (ini + tam));
+                b.dados = ini;
+                if (pos.paginas != Posicionamento::NORMAIS && madvise(ini, tam, MADV_HUGEPAGE) == 0)
+                    b.origem = TRANSPARENTE;
+            }
+            return b;
         }
+#endif
+        return {(char*)::operator new(tam, align_val_t(ALINHAMENTO_BLOCO)), tam, SISTEMA};
+    }
+
+    // Primeiro toque: cada thread escreve nas páginas do seu trecho e o kernel as
+    // coloca no nó dela. O vetor grande que abriu o bloco fica no início dele; com
+    // alinhamento = alignof(T), o tamanho do elemento nos vetores de escalares, a conta
+    // de threads e as faixas são as de paraleloBlocos sobre n = bytes / alinhamento
+    // elementos, e cada página vai para o nó da thread dona do seu primeiro byte. O
+    // resto do bloco fica para o primeiro uso.
+    void tocar(const Bloco& b, size_t bytes, size_t alinhamento) {
+#ifdef __linux__
+        size_t pag = b.origem == HUGETLB ? PAGINA_GRANDE : (size_t)sysconf(_SC_PAGESIZE);
+        size_t n = bytes / alinhamento, nt = threadsBlocos(n);
+        paraleloBlocos(nt, [&](size_t t0, size_t t1, size_t) {   // um item por thread
+            for (size_t t = t0; t < t1; t++) {
+                size_t ini = alinhamento * (n * t / nt), fim = t + 1 == nt ? bytes : alinhamento * (n * (t + 1) / nt);
+                for (size_t i = (ini + pag - 1) / pag; i * pag < fim; i++) ((volatile char*)b.dados)[i * pag] = 0;
+            }
+        }, 1);
+#else
+        (void)b, (void)bytes, (void)alinhamento;
+#endif
     }
-    return ((int)ordem.size() == qntV);
+
+    vector<Bloco> blocos;
+    size_t atual = 0, usado = 0;
+    size_t tamBloco;
+    Posicionamento pos;
+};
+
+// Resumo do posicionamento para a saída de execução: blocos por tipo de página, o
+// que o kernel confirmou como página grande transparente (AnonHugePages do
+// processo) e a residência por nó NUMA.
+void imprimirPosicionamento(const Arena& arena) {
+    const double MB = 1048576.0;
+    const Posicionamento& pos = arena.posicionamento();
+    size_t thp = 0;
+    ifstream smaps("/proc/self/smaps_rollup");
+    for (string linha; getline(smaps, linha);)
+        if (linha.rfind("AnonHugePages:", 0) == 0) thp = strtoull(linha.c_str() + 14, nullptr, 10) * 1024;
+    printf("\nMemória: arena %.1f MB em %zu bloco(s); páginas grandes: %.1f MB explícitas, "
+           "%.1f MB transparentes (%.1f MB confirmados), %.1f MB normais mapeados\n",
+           arena.bytesReservados() / MB, arena.quantidadeBlocos(), arena.bytesPorOrigem(Arena::HUGETLB) / MB,
+           arena.bytesPorOrigem(Arena::TRANSPARENTE) / MB, thp / MB, arena.bytesPorOrigem(Arena::MAPEADO) / MB);
+    const TopologiaNUMA& topo = TopologiaNUMA::instancia();
+    printf("NUMA: %zu nó(s), primeiro toque %s, threads %s; residente por nó:", topo.nos(),
+           pos.primeiroToque ? "paralelo" : "desligado", topo.fixarThreads ? "fixadas por nó" : "livres");
+    vector<size_t> porNo = arena.bytesPorNo();
+    for (size_t no = 0; no < porNo.size(); no++) printf(" %zu=%.1f MB", no, porNo[no] / MB);
+    printf(porNo.empty() ? " (indisponível)\n" : "\n");
 }
 
-// ---------------- cálculo PERT/CPM ----------------
-bool calcularPERT(int** mat, int qntV, const vector<string>& rotulos, const vector<int>& dur,
-                  vector<int>& ES, vector<int>& EF, vector<int>& LS, vector<int>& LF, int& duracaoProjeto) {
-
-    vector<int> ordem;
-    if (!topoOrdenacao(mat, qntV, ordem)) return false;
-
-    // -------- forward (ES/EF) --------
-    ES.assign(qntV, 0);
-    EF.assign(qntV, 0);
-    for (int idx = 0; idx < qntV; idx++) {
-        int u = ordem[idx];
-        int maxEfPred = 0;
-       
-        for (int p = 0; p < qntV; p++)
-            if (mat[p][u]) maxEfPred = max(maxEfPred, EF[p]);
-        ES[u] = maxEfPred;
-        EF[u] = ES[u] + dur[u];
+// Contêineres que podem morar na arena; sem recurso explícito usam new/delete.
+template <class T>
+using Vetor = pmr::vector<T>;
+
+// ---------------- rótulos empacotados ----------------
+// Todos os bytes dos rótulos num buffer só, com um vetor de deslocamentos: sem o
+// objeto string (32+ bytes) e a alocação própria de cada rótulo. O acesso é por
+// string_view.
+// compactar() troca para codificação por prefixo (front coding) em blocos de
+// BLOCO rótulos: o primeiro do bloco fica inteiro, os demais guardam só quanto
+// compartilham com o anterior e o sufixo. Com IDs hierárquicos ordenados
+// (PRJ-0042.WBS.3.2.17, PRJ-0042.WBS.3.2.18, ...) sobra pouco mais que o sufixo.
+// Compactado, cada acesso decodifica a partir da cabeça do bloco (até BLOCO-1 passos)
+// para um Rotulo que é dono do texto: nada de estado compartilhado entre acessos, a
+// leitura é segura entre threads e não se pode mais acrescentar rótulos.
+// repetir(k) faz os m rótulos guardados valerem como os m * k da rede repetida: o
+// rótulo i é "modelo[i % m]@(i / m + 1)", montado no acesso, sem texto por unidade.
+
+// Um rótulo lido: view dos bytes empacotados ou, compactado, o texto decodificado
+// guardado no próprio objeto. Converte para string_view, que vale enquanto ele existir.
+class Rotulo {
+public:
+    Rotulo(const Rotulo& o) : texto(o.texto), v(o.proprio() ? string_view(texto) : o.v) {}
+    Rotulo& operator=(const Rotulo& o) {
+        bool p = o.proprio();
+        texto = o.texto;
+        v = p ? string_view(texto) : o.v;
+        return *this;
     }
 
-    duracaoProjeto = 0;
-    for (int i = 0; i < qntV; i++) duracaoProjeto = max(duracaoProjeto, EF[i]);
+    operator string_view() const { return v; }
+    const char* data() const { return v.data(); }
+    size_t size() const { return v.size(); }
+    bool empty() const { return v.empty(); }
+    friend ostream& operator<<(ostream& o, const Rotulo& r) { return o << r.v; }
+
+private:
+    friend class Rotulos;
+    explicit Rotulo(string_view s) : v(s) {}
+    explicit Rotulo(string&& s) : texto(move(s)), v(texto) {}
+    bool proprio() const { return v.data() == texto.data(); }
+
+    string texto;
+    string_view v;
+};
+
+class Rotulos {
+public:
+    static constexpr size_t BLOCO = 16;
+
+    explicit Rotulos(pmr::memory_resource* mem = pmr::get_default_resource())
+        : dados(mem), inicio(1, 0, mem) {}
+    Rotulos(const Rotulos& o, pmr::memory_resource* mem = pmr::get_default_resource())
+        : dados(o.dados, mem), inicio(o.inicio, mem), quantidade(o.quantidade), compacto(o.compacto),
+          unidades(o.unidades) {}
+    Rotulos& operator=(const Rotulos& o) = default;
+
+    size_t size() const { return quantidade * unidades; }
+    bool empty() const { return quantidade == 0; }
+    bool compactado() const { return compacto; }
+    pmr::memory_resource* recurso() const { return dados.get_allocator().resource(); }
+    size_t bytes() const { return dados.size() + inicio.size() * sizeof(inicio[0]); }
 
-    // -------- backward (LS/LF) --------
-    LF.assign(qntV, numeric_limits<int>::max());
-    LS.assign(qntV, 0);
-    for (int i = 0; i < qntV; i++) {
-        bool temSuc = false;
-        for (int j = 0; j < qntV; j++) if (mat[i][j]) { temSuc = true; break; }
-        if (!temSuc) LF[i] = duracaoProjeto;
+    void reserve(size_t n, size_t bytesTexto = 0) {
+        inicio.reserve(n + 1);
+        dados.reserve(bytesTexto);
     }
+    void push_back(string_view s) {
+        dados.insert(dados.end(), s.begin(), s.end());
+        inicio.push_back(dados.size());
+        quantidade++;
+    }
+    void clear() {
+        dados.clear();
+        inicio.assign(1, 0);
+        quantidade = 0;
+        compacto = false;
+        unidades = 1;
+    }
+    void repetir(uint64_t k) { unidades = k; }
+    uint64_t repeticoes() const { return unidades; }
 
-    for (int idx = qntV - 1; idx >= 0; idx--) {
-        int u = ordem[idx];
-        int minLsSuc = numeric_limits<int>::max();
-        bool temSuc = false;
-        for (int v = 0; v < qntV; v++) if (mat[u][v]) {
-            temSuc = true;
-            minLsSuc = min(minLsSuc, LF[v] - dur[v]);
+    Rotulo operator[](size_t i) const {
+        if (unidades > 1) {
+            string texto = compacto ? decodificar(i % quantidade) : string(modelo(i % quantidade));
+            texto += '@';
+            texto += to_string(i / quantidade + 1);
+            return Rotulo(move(texto));
         }
-        if (temSuc) LF[u] = minLsSuc;
-        LS[u] = LF[u] - dur[u];
+        if (!compacto) return Rotulo(modelo(i));
+        return Rotulo(decodificar(i));
     }
-    return true;
-}
 
-// ---------------- encontrar um caminho crítico ----------------
-vector<int> encontrarCaminhoCritico(int** mat, int qntV, const vector<int>& ES, const vector<int>& EF, const vector<int>& LS, const vector<int>& LF) {
-    vector<int> floatTotal(qntV);
-    for (int i = 0; i < qntV; i++) floatTotal[i] = LS[i] - ES[i];
-
-    vector<int> starts;
-    for (int i = 0; i < qntV; i++) {
-        bool temPred = false;
-        for (int p = 0; p < qntV; p++){
-            if (mat[p][i]) { 
-                temPred = true; 
-                break;
+    // Passa para a codificação por prefixo se ela ocupar menos; retorna se passou.
+    bool compactar() {
+        if (compacto) return true;
+        Vetor<char> novo(recurso());
+        Vetor<uint64_t> blocos(recurso());
+        novo.reserve(dados.size());
+        blocos.reserve(quantidade / BLOCO + 2);
+        string_view ant;
+        for (size_t i = 0; i < quantidade; i++) {
+            string_view s = modelo(i);
+            if (i % BLOCO == 0) {
+                blocos.push_back(novo.size());
+                gravarVarint(novo, s.size());
+                novo.insert(novo.end(), s.begin(), s.end());
+            } else {
+                size_t comum = 0;
+                while (comum < ant.size() && comum < s.size() && ant[comum] == s[comum]) comum++;
+                gravarVarint(novo, comum);
+                gravarVarint(novo, s.size() - comum);
+                novo.insert(novo.end(), s.begin() + comum, s.end());
             }
+            ant = s;
+        }
+        blocos.push_back(novo.size());
+        if (novo.size() + blocos.size() * sizeof(uint64_t) >= bytes()) return false;
+        dados = move(novo);
+        inicio = move(blocos);
+        dados.shrink_to_fit();
+        compacto = true;
+        return true;
+    }
+
+private:
+    Vetor<char> dados;
+    Vetor<uint64_t> inicio;   // por rótulo (empacotado) ou por bloco (compactado)
+    size_t quantidade = 0;   // guardados; size() conta as repetições
+    bool compacto = false;
+    uint64_t unidades = 1;
+
+    string_view modelo(size_t i) const {   // empacotado
+        return string_view(dados.data() + inicio[i], (size_t)(inicio[i + 1] - inicio[i]));
+    }
+    static void gravarVarint(Vetor<char>& v, uint64_t x) {
+        while (x >= 0x80) { v.push_back((char)(x | 0x80)); x >>= 7; }
+        v.push_back((char)x);
+    }
+    uint64_t lerVarint(size_t& pos) const {
+        uint64_t x = 0;
+        for (unsigned desl = 0;; desl += 7) {
+            uint8_t b = (uint8_t)dados[pos++];
+            x |= (uint64_t)(b & 0x7F) << desl;
+            if (b < 0x80) return x;
         }
-        if (!temPred && floatTotal[i] == 0) {
-            starts.push_back(i);
+    }
+    string decodificar(size_t i) const {
+        size_t pos = inicio[i / BLOCO];
+        size_t tam = lerVarint(pos);
+        string texto(dados.data() + pos, tam);
+        pos += tam;
+        for (size_t j = i / BLOCO * BLOCO + 1; j <= i; j++) {
+            size_t comum = lerVarint(pos);
+            size_t sufixo = lerVarint(pos);
+            texto.resize(comum);
+            texto.append(dados.data() + pos, sufixo);
+            pos += sufixo;
         }
+        return texto;
+    }
+};
+
+// ---------------- tipos de índice e de tempo ----------------
+// Grafo e cronograma são templates no tipo de índice dos vértices (Idx) e no tipo
+// de tempo (Tempo). O carregador escolhe a menor instanciação que comporta o
+// plano (despacharTipos): uint16/uint32/uint64 conforme V e E. A família do tempo
+// é fixada na compilação:
+//   (padrão)           inteiro: int32 ou int64, conforme a soma das durações
+//   -DCPM_TEMPO_FIXO   ponto fixo, milésimos da unidade guardados em int64
+//   -DCPM_TEMPO_REAL   double
+
+// Ponto fixo com 3 casas decimais.
+struct TempoFixo {
+    static constexpr int64_t ESCALA = 1000;
+    int64_t bruto = 0;
+
+    static constexpr TempoFixo deBruto(int64_t b) {
+        TempoFixo t;
+        t.bruto = b;
+        return t;
+    }
+    friend constexpr TempoFixo operator+(TempoFixo a, TempoFixo b) { return deBruto(a.bruto + b.bruto); }
+    friend constexpr TempoFixo operator-(TempoFixo a, TempoFixo b) { return deBruto(a.bruto - b.bruto); }
+    friend constexpr bool operator==(TempoFixo a, TempoFixo b) { return a.bruto == b.bruto; }
+    friend constexpr bool operator!=(TempoFixo a, TempoFixo b) { return a.bruto != b.bruto; }
+    friend constexpr bool operator<(TempoFixo a, TempoFixo b) { return a.bruto < b.bruto; }
+    friend constexpr bool operator>(TempoFixo a, TempoFixo b) { return a.bruto > b.bruto; }
+    friend constexpr bool operator<=(TempoFixo a, TempoFixo b) { return a.bruto <= b.bruto; }
+    friend constexpr bool operator>=(TempoFixo a, TempoFixo b) { return a.bruto >= b.bruto; }
+};
+
+template <class T>
+struct TempoTraits {
+    static constexpr T maximo() { return numeric_limits<T>::max(); }
+    static T deReal(double d) {
+        if constexpr (is_integral_v<T>) return (T)llround(d);
+        else return (T)d;
     }
+    static double real(T v) { return (double)v; }
+    // menor valor maior que v: intervalos de duração zero viram [v, proximo(v))
+    static T proximo(T v) {
+        if constexpr (is_integral_v<T>) return v + 1;
+        else return nextafter(v, numeric_limits<T>::infinity());
+    }
+    // Igualdade de tempos calculados (folga zero, aresta justa): exata nos inteiros; em
+    // ponto flutuante, com tolerância relativa ao arredondamento das somas e subtrações
+    // (1.7 -> 2 dá LS = 2.2e-16 na atividade que abre o caminho crítico).
+    static bool igual(T a, T b) {
+        if constexpr (is_floating_point_v<T>)
+            return fabs(a - b) <= T(1e-9) * max({T(1), fabs(a), fabs(b)});
+        else return a == b;
+    }
+    static bool zero(T v) { return igual(v, T{}); }
+};
 
-    int inicio = -1;
-    if (!starts.empty()) inicio = starts[0];
-    else {
-        for (int i = 0; i < qntV; i++){
-            if (floatTotal[i] == 0) { 
-                inicio = i; break; 
+template <>
+struct TempoTraits<TempoFixo> {
+    static constexpr TempoFixo maximo() { return TempoFixo::deBruto(numeric_limits<int64_t>::max()); }
+    static TempoFixo deReal(double d) { return TempoFixo::deBruto(llround(d * TempoFixo::ESCALA)); }
+    static double real(TempoFixo v) { return (double)v.bruto / TempoFixo::ESCALA; }
+    static TempoFixo proximo(TempoFixo v) { return TempoFixo::deBruto(v.bruto + 1); }
+    static bool igual(TempoFixo a, TempoFixo b) { return a == b; }
+    static bool zero(TempoFixo v) { return v.bruto == 0; }
+};
+
+// Texto de um tempo em 'buf' (sem alocação); devolve a view sobre o trecho escrito.
+template <class T>
+string_view formatarTempo(T v, char* buf, size_t tam) {
+    if constexpr (is_same_v<T, TempoFixo>) {
+        int64_t b = v.bruto;
+        char* p = buf;
+        if (b < 0) { *p++ = '-'; b = -b; }
+        p = to_chars(p, buf + tam, b / TempoFixo::ESCALA).ptr;
+        int frac = (int)(b % TempoFixo::ESCALA);
+        if (frac) {
+            *p++ = '.';
+            for (int d = (int)TempoFixo::ESCALA / 10; d && frac; d /= 10) {
+                *p++ = (char)('0' + frac / d);
+                frac %= d;
             }
-        }   
+        }
+        return string_view(buf, (size_t)(p - buf));
+    } else {
+        return string_view(buf, (size_t)(to_chars(buf, buf + tam, v).ptr - buf));
+    }
+}
+
+// Versão com terminador nulo para printf: textoTempo(v, buf) com char buf[32].
+template <class T>
+const char* textoTempo(T v, char (&buf)[32]) {
+    buf[formatarTempo(v, buf, sizeof(buf) - 1).size()] = '\0';
+    return buf;
+}
+
+template <class T> constexpr const char* nomeTipo();
+template <> constexpr const char* nomeTipo<uint16_t>() { return "uint16"; }
+template <> constexpr const char* nomeTipo<uint32_t>() { return "uint32"; }
+template <> constexpr const char* nomeTipo<uint64_t>() { return "uint64"; }
+template <> constexpr const char* nomeTipo<int32_t>() { return "int32"; }
+template <> constexpr const char* nomeTipo<int64_t>() { return "int64"; }
+template <> constexpr const char* nomeTipo<double>() { return "double"; }
+template <> constexpr const char* nomeTipo<TempoFixo>() { return "fixo(0.001)"; }
+
+#if defined(CPM_TEMPO_FIXO)
+using TempoFracionario = TempoFixo;
+#elif defined(CPM_TEMPO_REAL)
+using TempoFracionario = double;
+#endif
+
+// Durações como lidas da entrada, antes da escolha do tipo de tempo.
+#if defined(CPM_TEMPO_FIXO) || defined(CPM_TEMPO_REAL)
+using DuracaoEntrada = double;
+#else
+using DuracaoEntrada = int64_t;
+#endif
+
+// ---------------- índice de rótulos (hash) ----------------
+// Guarda string_view dos rótulos: o vetor indexado não pode ser alterado depois. Compactado
+// ou repetido, rotulos[i] devolve um texto próprio que some com o temporário; aí as chaves
+// apontam para uma cópia empacotada guardada no índice.
+// Rótulo repetido fica com o primeiro índice, como na busca linear.
+class IndiceRotulos {
+public:
+    IndiceRotulos() = default;
+    // a tabela fica no mesmo recurso de memória dos rótulos
+    explicit IndiceRotulos(const Rotulos& rotulos) : mapa(rotulos.recurso()), proprios(rotulos.recurso()) {
+        construir(rotulos);
     }
 
-    vector<int> caminho;
-    if (inicio == -1) {
-        return caminho; 
+    void construir(const Rotulos& rotulos) {
+        mapa.clear();
+        proprios.clear();
+        const Rotulos* chaves = &rotulos;
+        if (rotulos.compactado() || rotulos.repeticoes() != 1) {
+            proprios.reserve(rotulos.size());
+            for (size_t i = 0; i < rotulos.size(); i++) proprios.push_back(rotulos[i]);
+            chaves = &proprios;
+        }
+        mapa.reserve(chaves->size());
+        for (size_t i = 0; i < chaves->size(); i++) mapa.emplace((*chaves)[i], (int64_t)i);
     }
-    int cur = inicio;
-    caminho.push_back(cur);
+    int64_t buscar(string_view valor) const {
+        auto it = mapa.find(valor);
+        return it == mapa.end() ? -1 : it->second;
+    }
+
+private:
+    pmr::unordered_map<string_view, int64_t> mapa;
+    Rotulos proprios;   // só com rótulos compactados ou repetidos
+};
+
+// ---------------- leitura de predecessores ----------------
+// Separa "A,B,C" sem criar strings intermediárias; 'preds' é reaproveitado entre linhas.
+// Retorna false se algum rótulo não existe.
+bool lerPredecessores(string_view linha, const IndiceRotulos& indice, Vetor<int64_t>& preds) {
+    preds.clear();
+    if (linha == "-") return true;
+    bool valido = true;
     while (true) {
-        int proximo = -1;
-        for (int v = 0; v < qntV; v++) {
-            if (mat[cur][v] && (LS[v] - ES[v] == 0) && ES[v] == EF[cur]) {
-                proximo = v;
-                break;
-            }
+        size_t virgula = linha.find(',');
+        int64_t idx = indice.buscar(linha.substr(0, virgula));
+        if (idx == -1) valido = false;
+        preds.push_back(idx);
+        if (virgula == string_view::npos) break;
+        linha.remove_prefix(virgula + 1);
+    }
+    return valido;
+}
+
+// ---------------- campos de uma linha (eventos, comandos, progresso) ----------------
+// Campos separados por espaço ou tabulação até o fim ou até um '#' (comentário), como
+// views de 'linha'; 'campos' é reaproveitado entre linhas.
+void separarCampos(string_view linha, vector<string_view>& campos) {
+    campos.clear();
+    for (size_t p = 0;;) {
+        p = linha.find_first_not_of(" \t\r", p);
+        if (p == string_view::npos || linha[p] == '#') break;
+        size_t q = min(linha.find_first_of(" \t\r", p), linha.size());
+        campos.push_back(linha.substr(p, q - p));
+        p = q;
+    }
+}
+
+// Duração ou data >= 0 ocupando o campo inteiro.
+bool lerNumero(string_view s, DuracaoEntrada& x) {
+    auto r = from_chars(s.data(), s.data() + s.size(), x);
+    return r.ec == errc() && r.ptr == s.data() + s.size() && x >= 0;
+}
+
+// ---------------- plano lido da entrada ----------------
+// Em tipos largos; executar<Idx, Tempo> converte para a instanciação escolhida.
+
+// Ligação entre unidades de uma rede repetida: 'destino' na unidade u + defasagem
+// depende de 'origem' na unidade u (índices de atividade do modelo, defasagem >= 1).
+struct Ligacao {
+    uint64_t origem, destino, defasagem;
+};
+
+// Quantidade de um recurso renovável (equipe, máquina) ocupada enquanto a atividade executa.
+struct UsoRecurso {
+    uint32_t recurso;
+    int64_t quantidade;
+};
+
+struct Plano {
+    Rotulos rotulos;
+    Vetor<DuracaoEntrada> dur;
+    Vetor<uint64_t> predInicio, predAlvo;   // predecessores digitados de cada atividade
+    // Rede repetida (linha de balanço): as atividades acima formam o modelo de uma
+    // unidade (pavimento, trecho...), repetido 'unidades' vezes; a atividade a da
+    // unidade u vira o vértice u * qntV() + a.
+    uint64_t unidades = 1;
+    Vetor<Ligacao> ligacoes;
+    // Progresso (--progresso): situação como em ReprogramacaoCPM (0 não iniciada,
+    // 1 em andamento, 2 concluída) e datas reais; vazio = cronograma a partir do zero.
+    Vetor<uint8_t> situacao;
+    Vetor<DuracaoEntrada> inicioReal, fimReal, restante;
+    DuracaoEntrada dataStatus = 0;
+    // Custo total e taxa de recurso (--custos); vazio = custo igual à duração, 1 unidade.
+    Vetor<double> custo, recurso;
+    // Recursos renováveis (--recursos): nome e capacidade de cada um; a atividade a usa
+    // usos[usoInicio[a] .. usoInicio[a + 1]). Vazio = sem restrição de recursos.
+    vector<string> nomesRecursos;
+    Vetor<int64_t> capacidade;
+    Vetor<uint64_t> usoInicio;
+    Vetor<UsoRecurso> usos;
+    // Não renováveis (consumivel em --recursos: verba, material): total do projeto e o
+    // consumo de cada atividade em consumos[consumoInicio[a] .. consumoInicio[a + 1]).
+    vector<string> nomesConsumiveis;
+    Vetor<int64_t> totalConsumivel;
+    Vetor<uint64_t> consumoInicio;
+    Vetor<UsoRecurso> consumos;
+    // Modos (--modos): a atividade a executa num dos modos [modoInicio[a], modoInicio[a + 1]);
+    // o modo k dura modoDur[k], usa modoUsos[modoUsoInicio[k] ..] e consome
+    // modoConsumos[modoConsumoInicio[k] ..]. Vazio = um modo só, o digitado.
+    Vetor<uint64_t> modoInicio;
+    Vetor<DuracaoEntrada> modoDur;
+    Vetor<uint64_t> modoUsoInicio, modoConsumoInicio;
+    Vetor<UsoRecurso> modoUsos, modoConsumos;
+
+    explicit Plano(pmr::memory_resource* mem = pmr::get_default_resource())
+        : rotulos(mem), dur(mem), predInicio(mem), predAlvo(mem), ligacoes(mem), situacao(mem), inicioReal(mem),
+          fimReal(mem), restante(mem), custo(mem), recurso(mem), capacidade(mem), usoInicio(mem), usos(mem),
+          totalConsumivel(mem), consumoInicio(mem), consumos(mem), modoInicio(mem), modoDur(mem), modoUsoInicio(mem),
+          modoConsumoInicio(mem), modoUsos(mem), modoConsumos(mem) {}
+    size_t qntV() const { return rotulos.size(); }
+    bool temProgresso() const { return !situacao.empty(); }
+    bool temRecursos() const { return !usoInicio.empty(); }
+    bool temModos() const { return !modoInicio.empty(); }
+    uint64_t qntVExpandido() const { return qntV() * unidades; }
+    uint64_t qntEExpandido() const {
+        uint64_t e = predAlvo.size() * unidades;
+        for (const Ligacao& l : ligacoes) if (l.defasagem < unidades) e += unidades - l.defasagem;
+        return e;
+    }
+};
+
+// ---------------- leitura do plano digitado ----------------
+// Quantidade, rótulos, durações e uma linha de predecessores por atividade ("A,B" ou
+// "-"), do teclado ou de um arquivo da sessão. Com 'interativo', mostra os pedidos e
+// pede de novo o que vier inválido; sem ele, a primeira falha vira o motivo em 'erro'.
+// O fim da entrada antes do plano completo é falha nos dois casos. A lista da
+// atividade i (índices, talvez repetidos) vai para predecessores(i, lista); 'indice'
+// (criado sobre plano.rotulos) termina com os rótulos lidos.
+template <class F>
+bool lerPlanoTexto(istream& in, Plano& plano, bool interativo, IndiceRotulos& indice, string& erro,
+                   F&& predecessores) {
+    auto pedir = [&](auto&&... x) { if (interativo) (cout << ... << x); };
+    auto descartarLinha = [&] {
+        in.clear();
+        in.ignore(numeric_limits<streamsize>::max(), '\n');
+    };
+    long long n;
+    pedir("Quantidade de atividades: ");
+    while (!(in >> n) || n <= 0) {
+        if (!interativo || in.eof()) return erro = "quantidade de atividades inválida", false;
+        pedir("Entrada inválida. Digite um inteiro > 0: ");
+        descartarLinha();
+    }
+    in.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    plano.rotulos.reserve(n);
+    plano.dur.assign(n, 0);
+
+    pedir("\nDigite os rótulos:\n");
+    string rotulo;
+    for (long long i = 0; i < n; i++) {
+        pedir("Rótulo atividade ", i + 1, ": ");
+        if (!(in >> rotulo)) return erro = "faltam rótulos", false;
+        plano.rotulos.push_back(rotulo);
+    }
+
+    pedir("\nDigite as durações:\n");
+    for (long long i = 0; i < n; i++) {
+        pedir("Duração de ", plano.rotulos[i], ": ");
+        while (!(in >> plano.dur[i]) || plano.dur[i] < 0) {
+            if (!interativo || in.eof()) return erro = "duração inválida de " + string(plano.rotulos[i]), false;
+            pedir(is_integral_v<DuracaoEntrada> ? "Duração inválida. Digite inteiro >= 0: "
+                                                : "Duração inválida. Digite número >= 0: ");
+            descartarLinha();
         }
-        if (proximo == -1) break;
-        caminho.push_back(proximo);
-        cur = proximo;
     }
-    return caminho;
+    in.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    indice.construir(plano.rotulos);
+
+    // linha i = predecessores de i; linha vazia não conta
+    Vetor<int64_t> pl(plano.predAlvo.get_allocator().resource());
+    string linha;
+    pedir("\nDigite os predecessores para cada atividade.\nExemplo: A,B ou '-' se nenhum.\n");
+    for (long long i = 0; i < n;) {
+        pedir("Predecessores de ", plano.rotulos[i], " : ");
+        if (!getline(in, linha)) return erro = "faltam predecessores", false;
+        if (!linha.empty() && linha.back() == '\r') linha.pop_back();
+        if (linha.empty()) continue;
+        if (!lerPredecessores(linha, indice, pl)) {
+            if (!interativo) return erro = "predecessor inexistente de " + string(plano.rotulos[i]), false;
+            pedir("Um ou mais rótulos não existem. Digite novamente.\n");
+            continue;
+        }
+        predecessores((uint64_t)i++, pl);
+    }
+    return true;
 }
 
-// ---------------- gerar JSON para visualização externa ----------------
-void gerarJSON_vis(int** mat, int qntV,
-                   const vector<string>& rotulos,
-                   const vector<int>& dur,
-                   const vector<int>& caminhoCrit,
-                   const vector<int>& ES, const vector<int>& EF,
-                   const vector<int>& LS, const vector<int>& LF) {
+// Listas guardadas no plano (predInicio/predAlvo), para construirGrafo.
+bool lerPlanoTexto(istream& in, Plano& plano, bool interativo, IndiceRotulos& indice, string& erro) {
+    plano.predInicio.assign(1, 0);
+    return lerPlanoTexto(in, plano, interativo, indice, erro, [&](uint64_t, const Vetor<int64_t>& pl) {
+        plano.predAlvo.insert(plano.predAlvo.end(), pl.begin(), pl.end());
+        plano.predInicio.push_back(plano.predAlvo.size());
+    });
+}
+
+// ---------------- listas de adjacência (CSR) ----------------
+// Vizinhos de u ficam em alvo[inicio[u] .. inicio[u+1]), em ordem crescente.
+// Deslocamentos em 32 bits enquanto E couber neles (índices de 16/32 bits).
+template <class Idx>
+using Desl = conditional_t<(sizeof(Idx) < 8), uint32_t, uint64_t>;
+
+template <class Idx>
+struct ListaAdj {
+    Vetor<Desl<Idx>> inicio;
+    Vetor<Idx> alvo;
+    explicit ListaAdj(pmr::memory_resource* mem = pmr::get_default_resource()) : inicio(mem), alvo(mem) {}
+    Desl<Idx> grau(Idx u) const { return inicio[u + 1] - inicio[u]; }
+    uint64_t arestas() const { return alvo.size(); }
+    size_t bytes() const { return inicio.size() * sizeof(inicio[0]) + alvo.size() * sizeof(Idx); }
+    // chama f(v) para cada vizinho v de u, em ordem crescente
+    template <class F>
+    void paraCada(Idx u, F&& f) const {
+        for (auto k = inicio[u]; k < inicio[u + 1]; k++) f(alvo[k]);
+    }
+};
+
+// Transposta por contagem: percorrer u em ordem crescente já deixa cada lista ordenada.
+// O resultado fica no mesmo recurso de memória da entrada.
+template <class Idx>
+ListaAdj<Idx> transpor(const ListaAdj<Idx>& a, Idx qntV) {
+    pmr::memory_resource* mem = a.alvo.get_allocator().resource();
+    ListaAdj<Idx> t(mem);
+    t.inicio.assign((size_t)qntV + 1, 0);
+    for (Idx v : a.alvo) t.inicio[v + 1]++;
+    for (Idx v = 0; v < qntV; v++) t.inicio[v + 1] += t.inicio[v];
+    t.alvo.resize(a.alvo.size());
+    Vetor<Desl<Idx>> pos(t.inicio.begin(), t.inicio.end() - 1, mem);
+    for (Idx u = 0; u < qntV; u++)
+        for (auto k = a.inicio[u]; k < a.inicio[u + 1]; k++)
+            t.alvo[pos[a.alvo[k]]++] = u;
+    return t;
+}
+
+// ---------------- listas comprimidas (delta + group-varint) ----------------
+// Cada lista ordenada vira diferenças entre vizinhos consecutivos (o primeiro
+// vizinho é a diferença para 0). A lista começa pelo grau em varint de prefixo
+// (n-1 zeros à direita no primeiro byte para n bytes; byte 0 = 8 bytes crus) e
+// segue em grupos de 4 diferenças: um byte de controle com 2 bits de tamanho por
+// valor e os valores em 1-4 bytes (1/2/4/8 com índice de 64 bits). Como os quatro
+// tamanhos saem de um byte só, as leituras do grupo não dependem umas das outras,
+// ao contrário do LEB128 byte a byte. Listas com vizinhos próximos ficam perto de
+// 1,25-2,5 bytes por aresta, e paraCada decodifica durante a varredura.
+template <class Idx>
+struct ListaComprimida {
+    static constexpr size_t FOLGA = 8;   // bytes extras no fim de dados: a leitura de 8 bytes nunca sai do vetor
+    static constexpr unsigned TAM[4] = {1, 2, sizeof(Idx) < 8 ? 3u : 4u, sizeof(Idx) < 8 ? 4u : 8u};
+    static constexpr uint64_t MASCARA[4] = {0xFF, 0xFFFF, sizeof(Idx) < 8 ? 0xFFFFFFull : 0xFFFFFFFFull,
+                                            sizeof(Idx) < 8 ? 0xFFFFFFFFull : ~0ull};
+
+    Vetor<uint64_t> inicio;   // bytes de u em dados[inicio[u] .. inicio[u+1])
+    Vetor<uint8_t> dados;
+    explicit ListaComprimida(pmr::memory_resource* mem = pmr::get_default_resource()) : inicio(mem), dados(mem) {}
+
+    uint64_t grau(Idx u) const {
+        const uint8_t* p = dados.data() + inicio[u];
+        return lerVarint(p);
+    }
+    uint64_t arestas() const {
+        uint64_t g = 0;
+        for (size_t u = 0; u + 1 < inicio.size(); u++) g += grau((Idx)u);
+        return g;
+    }
+    size_t bytes() const { return inicio.size() * sizeof(inicio[0]) + dados.size(); }
+
+    template <class F>
+    void paraCada(Idx u, F&& f) const {
+        const uint8_t* p = dados.data() + inicio[u];
+        uint64_t g = lerVarint(p);
+        uint64_t v = 0;
+        auto passo = [&](unsigned cod) {
+            v += ler64(p) & MASCARA[cod];
+            p += TAM[cod];
+            f((Idx)v);
+        };
+        for (; g >= 4; g -= 4) {
+            unsigned c = *p++;
+            passo(c & 3);
+            passo((c >> 2) & 3);
+            passo((c >> 4) & 3);
+            passo(c >> 6);
+        }
+        if (g) {
+            unsigned c = *p++;
+            for (unsigned j = 0; j < g; j++) passo((c >> (2 * j)) & 3);
+        }
+    }
 
-    vector<pair<string, string>> critEdges;
-    auto folga = [&](int i){ return LS[i] - ES[i]; };
-    for (int u = 0; u < qntV; u++) {
-        for (int v = 0; v < qntV; v++) {
-            if (mat[u][v] && folga(u)==0 && folga(v)==0 && ES[v]==EF[u]) {
-                critEdges.emplace_back(rotulos[u], rotulos[v]);
+    // ---- codificação ----
+    static unsigned codigo(uint64_t x) {
+        unsigned c = 0;
+        while (c < 3 && x >> (8 * TAM[c])) c++;
+        return c;
+    }
+    static uint8_t* gravar(uint8_t* p, uint64_t x, unsigned n) {
+        for (unsigned i = 0; i < n; i++) *p++ = (uint8_t)(x >> (8 * i));
+        return p;
+    }
+    static unsigned tamanhoVarint(uint64_t x) {
+        unsigned n = 1;
+        while (n < 9 && (x >> (7 * n)) != 0) n++;
+        return n;
+    }
+    static uint8_t* gravarVarint(uint8_t* p, uint64_t x) {
+        unsigned n = tamanhoVarint(x);
+        if (n == 9) {
+            *p++ = 0;
+            return gravar(p, x, 8);
+        }
+        return gravar(p, (x << n) | (1ull << (n - 1)), n);
+    }
+    // Acrescenta uma lista ordenada e sem repetição ao fim de dados.
+    void anexar(const Idx* ini, const Idx* fim) {
+        uint8_t buf[9 + 1 + 4 * 8];
+        dados.insert(dados.end(), buf, gravarVarint(buf, (uint64_t)(fim - ini)));
+        uint64_t ant = 0;
+        while (ini < fim) {
+            uint8_t* q = buf + 1;
+            buf[0] = 0;
+            for (unsigned j = 0; j < 4 && ini < fim; j++, ini++) {
+                uint64_t x = (uint64_t)*ini - ant;
+                unsigned c = codigo(x);
+                buf[0] |= (uint8_t)(c << (2 * j));
+                q = gravar(q, x, TAM[c]);
+                ant = *ini;
             }
+            dados.insert(dados.end(), buf, q);
         }
     }
 
-    ofstream f("grafo.json");
-    if (!f.is_open()) {
-        cerr << "Aviso: não foi possível criar grafo.json.\n";
-        return;
+private:
+    static uint64_t ler64(const uint8_t* p) {
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        w = __builtin_bswap64(w);
+#endif
+        return w;
+    }
+    static uint64_t lerVarint(const uint8_t*& p) {
+        uint64_t w = ler64(p);
+        if ((uint8_t)w == 0) {
+            p += 9;
+            return ler64(p - 8);
+        }
+        unsigned n = (unsigned)__builtin_ctzll(w) + 1;
+        p += n;
+        return (w & (~0ull >> (64 - 8 * n))) >> n;
     }
+};
 
-    f << "{\n";
-    f << "  \"nodes\": [\n";
-    for (int i = 0; i < qntV; i++) {
-        f << "    {\"id\": " << quoted(rotulos[i]) << ", \"duration\": " << dur[i] << "}";
-        if (i != qntV - 1) f << ",";
-        f << "\n";
+template <class Idx, class Adj = ListaAdj<Idx>>
+struct Grafo {
+    static constexpr Idx NENHUM = numeric_limits<Idx>::max();   // por isso V < NENHUM
+    Idx qntV = 0;
+    Adj suc, pred;
+    explicit Grafo(pmr::memory_resource* mem = pmr::get_default_resource()) : suc(mem), pred(mem) {}
+};
+
+// ---------------- rede repetida (linha de balanço) ----------------
+// Adjacência implícita do modelo de m atividades repetido em 'unidades' unidades:
+// guarda só as listas do modelo e as ligações entre unidades, O(m + E do modelo +
+// ligações) para qualquer número de unidades. Os vizinhos são gerados na hora, em
+// ordem crescente: nos sucessores, primeiro os da própria unidade, depois as
+// ligações por defasagem crescente; nos predecessores, o inverso. Como toda
+// ligação avança ao menos uma unidade, a rede expandida é acíclica se o modelo for.
+template <class Idx>
+struct ListaRepetida {
+    ListaAdj<Idx> modelo;          // listas dentro de uma unidade
+    Vetor<Desl<Idx>> ligInicio;    // ligações da atividade a: lig[ligInicio[a] .. ligInicio[a+1])
+    Vetor<pair<Idx, Idx>> lig;     // (defasagem, atividade do modelo)
+    Idx m = 0, unidades = 0;
+    bool paraTras = false;         // predecessores: ligações voltam 'defasagem' unidades
+
+    explicit ListaRepetida(pmr::memory_resource* mem = pmr::get_default_resource())
+        : modelo(mem), ligInicio(mem), lig(mem) {}
+    Desl<Idx> grau(Idx u) const {
+        Idx un = u / m, a = u % m;
+        Desl<Idx> g = modelo.grau(a);
+        for (auto k = ligInicio[a]; k < ligInicio[a + 1]; k++) g += existe(un, lig[k].first);
+        return g;
+    }
+    uint64_t arestas() const {
+        uint64_t e = modelo.arestas() * unidades;
+        for (auto& l : lig) if (l.first < unidades) e += unidades - l.first;
+        return e;
+    }
+    size_t bytes() const {
+        return modelo.bytes() + ligInicio.size() * sizeof(ligInicio[0]) + lig.size() * sizeof(lig[0]);
+    }
+    template <class F>
+    void paraCada(Idx u, F&& f) const {
+        Idx un = u / m, a = u % m, base = un * m;
+        if (paraTras)
+            for (auto k = ligInicio[a]; k < ligInicio[a + 1]; k++)
+                if (existe(un, lig[k].first)) f((Idx)((un - lig[k].first) * m + lig[k].second));
+        modelo.paraCada(a, [&](Idx b) { f((Idx)(base + b)); });
+        if (!paraTras)
+            for (auto k = ligInicio[a]; k < ligInicio[a + 1]; k++)
+                if (existe(un, lig[k].first)) f((Idx)((un + lig[k].first) * m + lig[k].second));
     }
-    f << "  ],\n";
 
-    f << "  \"edges\": [\n";
-    bool first = true;
-    auto writeComma = [&](bool &first) { if (!first) f << ",\n"; else first = false; };
+private:
+    bool existe(Idx un, Idx defasagem) const {
+        return paraTras ? un >= defasagem : defasagem < unidades - un;
+    }
+};
 
-    for (int i = 0; i < qntV; i++) {
-        for (int j = 0; j < qntV; j++) {
-            if (mat[i][j]) {
-                writeComma(first);
-                f << "    {\"from\": " << quoted(rotulos[i]) << ", \"to\": " << quoted(rotulos[j]) << "}";
-            }
+// Sucessores e predecessores em O(V+E) a partir dos predecessores digitados;
+// predecessor repetido conta uma vez só.
+template <class Idx>
+void construirGrafo(const Plano& p, Grafo<Idx>& g) {
+    pmr::memory_resource* mem = g.suc.alvo.get_allocator().resource();
+    g.qntV = (Idx)p.qntV();
+    ListaAdj<Idx> bruta(mem);
+    bruta.inicio.assign((size_t)g.qntV + 1, 0);
+    bruta.alvo.reserve(p.predAlvo.size());
+    Vetor<Idx> visto(g.qntV, Grafo<Idx>::NENHUM, mem);
+    for (Idx v = 0; v < g.qntV; v++) {
+        for (uint64_t k = p.predInicio[v]; k < p.predInicio[v + 1]; k++) {
+            Idx u = (Idx)p.predAlvo[k];
+            if (visto[u] != v) { visto[u] = v; bruta.alvo.push_back(u); }
         }
+        bruta.inicio[v + 1] = (Desl<Idx>)bruta.alvo.size();
     }
-    f << "\n  ],\n";
+    g.suc = transpor(bruta, g.qntV);
+    g.pred = transpor(g.suc, g.qntV);
+}
 
-    f << "  \"critical_path\": [\n";
-    for (int i = 0; i < (int)caminhoCrit.size(); i++) {
-        f << "    " << quoted(rotulos[caminhoCrit[i]]);
-        if (i != (int)caminhoCrit.size() - 1) f << ",";
-        f << "\n";
+// Mesma construção direto no formato comprimido, sem passar por CSR: cada lista de
+// predecessores é ordenada e codificada; os sucessores saem da transposta em duas
+// passadas (tamanho em bytes de cada lista, depois gravação), já em ordem crescente.
+template <class Idx>
+void construirGrafo(const Plano& p, Grafo<Idx, ListaComprimida<Idx>>& g) {
+    using Lista = ListaComprimida<Idx>;
+    pmr::memory_resource* mem = g.suc.dados.get_allocator().resource();
+    const Idx NENHUM = Grafo<Idx>::NENHUM;
+    Idx n = g.qntV = (Idx)p.qntV();
+
+    Lista& pred = g.pred;
+    pred.inicio.assign((size_t)n + 1, 0);
+    pred.dados.clear();
+    Vetor<Idx> lista(mem);
+    for (Idx v = 0; v < n; v++) {
+        lista.assign(p.predAlvo.begin() + p.predInicio[v], p.predAlvo.begin() + p.predInicio[v + 1]);
+        sort(lista.begin(), lista.end());
+        lista.erase(unique(lista.begin(), lista.end()), lista.end());
+        pred.anexar(lista.data(), lista.data() + lista.size());
+        pred.inicio[v + 1] = pred.dados.size();
     }
-    f << "  ],\n";
+    pred.dados.resize(pred.dados.size() + Lista::FOLGA, 0);
 
-    f << "  \"critical_edges\": [\n";
-    for (size_t i = 0; i < critEdges.size(); ++i) {
-        f << "    {\"from\": " << quoted(critEdges[i].first) << ", \"to\": " << quoted(critEdges[i].second) << "}";
-        if (i != critEdges.size() - 1) f << ",";
-        f << "\n";
+    // 1ª passada: grau e bytes de valores de cada lista de sucessores
+    Lista& suc = g.suc;
+    Vetor<uint64_t> grau(n, 0, mem);
+    Vetor<Idx> ultimo(n, NENHUM, mem);
+    suc.inicio.assign((size_t)n + 1, 0);
+    for (Idx v = 0; v < n; v++)
+        pred.paraCada(v, [&](Idx u) {
+            suc.inicio[u + 1] += Lista::TAM[Lista::codigo(ultimo[u] == NENHUM ? v : v - ultimo[u])];
+            ultimo[u] = v;
+            grau[u]++;
+        });
+    for (Idx u = 0; u < n; u++)
+        suc.inicio[u + 1] += suc.inicio[u] + Lista::tamanhoVarint(grau[u]) + (grau[u] + 3) / 4;
+
+    // 2ª passada: grava; 'controle' aponta o byte de controle do grupo aberto de u
+    suc.dados.assign(suc.inicio[n] + Lista::FOLGA, 0);
+    uint8_t* d = suc.dados.data();
+    Vetor<uint64_t> pos(n, 0, mem), controle(n, 0, mem);
+    for (Idx u = 0; u < n; u++) pos[u] = Lista::gravarVarint(d + suc.inicio[u], grau[u]) - d;
+    fill(grau.begin(), grau.end(), 0);   // passa a contar os já gravados
+    fill(ultimo.begin(), ultimo.end(), NENHUM);
+    for (Idx v = 0; v < n; v++)
+        pred.paraCada(v, [&](Idx u) {
+            if (grau[u] % 4 == 0) controle[u] = pos[u]++;
+            uint64_t x = ultimo[u] == NENHUM ? v : v - ultimo[u];
+            unsigned c = Lista::codigo(x);
+            d[controle[u]] |= (uint8_t)(c << (2 * (grau[u] % 4)));
+            pos[u] = Lista::gravar(d + pos[u], x, Lista::TAM[c]) - d;
+            ultimo[u] = v;
+            grau[u]++;
+        });
+}
+
+// Rede repetida: listas do modelo pela construção CSR e ligações agrupadas por
+// atividade, cada direção já na ordem que paraCada percorre. Ligação repetida
+// conta uma vez só, como predecessor repetido.
+template <class Idx>
+void construirGrafo(const Plano& p, Grafo<Idx, ListaRepetida<Idx>>& g) {
+    pmr::memory_resource* mem = g.suc.lig.get_allocator().resource();
+    Grafo<Idx> modelo(mem);
+    construirGrafo(p, modelo);
+    g.qntV = (Idx)p.qntVExpandido();
+    Vetor<Ligacao> ligs(p.ligacoes.begin(), p.ligacoes.end(), mem);
+    for (int lado = 0; lado < 2; lado++) {
+        ListaRepetida<Idx>& l = lado ? g.pred : g.suc;
+        l.modelo = lado ? move(modelo.pred) : move(modelo.suc);
+        l.m = modelo.qntV;
+        l.unidades = (Idx)p.unidades;
+        l.paraTras = lado == 1;
+        auto dono = [&](const Ligacao& x) { return lado ? x.destino : x.origem; };
+        auto outro = [&](const Ligacao& x) { return lado ? x.origem : x.destino; };
+        // sucessores: defasagem crescente; predecessores: decrescente; empate pela atividade
+        sort(ligs.begin(), ligs.end(), [&](const Ligacao& a, const Ligacao& b) {
+            if (dono(a) != dono(b)) return dono(a) < dono(b);
+            if (a.defasagem != b.defasagem) return lado ? a.defasagem > b.defasagem : a.defasagem < b.defasagem;
+            return outro(a) < outro(b);
+        });
+        l.ligInicio.assign((size_t)l.m + 1, 0);
+        l.lig.clear();
+        for (size_t k = 0; k < ligs.size(); k++) {
+            if (k && dono(ligs[k]) == dono(ligs[k - 1]) && outro(ligs[k]) == outro(ligs[k - 1]) &&
+                ligs[k].defasagem == ligs[k - 1].defasagem) continue;
+            // defasagem além da última unidade não gera aresta; saturar evita estouro no Idx
+            Idx d = (Idx)min<uint64_t>(ligs[k].defasagem, p.unidades);
+            l.lig.push_back({d, (Idx)outro(ligs[k])});
+            l.ligInicio[dono(ligs[k]) + 1]++;
+        }
+        for (Idx a = 0; a < l.m; a++) l.ligInicio[a + 1] += l.ligInicio[a];
     }
-    f << "  ]\n";
+}
 
-    f << "}\n";
-    f.close();
+// ---------------- listas dinâmicas (grafo residente) ----------------
+// Um vetor ordenado por vértice: inserir e apagar custam O(grau), sem reconstruir
+// nada, para o grafo da sessão que muda entre cálculos. Vértices novos entram com
+// redimensionar; os passos de EspacoCPM e o caminho crítico enxergam o mesmo grau/
+// paraCada das listas CSR.
+template <class Idx>
+struct ListaDinamica {
+    Vetor<Vetor<Idx>> listas;
+    uint64_t total = 0;
+
+    explicit ListaDinamica(pmr::memory_resource* mem = pmr::get_default_resource()) : listas(mem) {}
+    Desl<Idx> grau(Idx u) const { return (Desl<Idx>)listas[u].size(); }
+    uint64_t arestas() const { return total; }
+    size_t bytes() const {
+        size_t b = listas.capacity() * sizeof(listas[0]);
+        for (const Vetor<Idx>& l : listas) b += l.capacity() * sizeof(Idx);
+        return b;
+    }
+    template <class F>
+    void paraCada(Idx u, F&& f) const {
+        for (Idx v : listas[u]) f(v);
+    }
+    const Vetor<Idx>& operator[](Idx u) const { return listas[u]; }
+
+    void redimensionar(size_t n) { listas.resize(n); }
+    bool contem(Idx u, Idx v) const { return binary_search(listas[u].begin(), listas[u].end(), v); }
+    // false se a aresta já existia (ou não existia, em apagar)
+    bool inserir(Idx u, Idx v) {
+        Vetor<Idx>& l = listas[u];
+        auto it = lower_bound(l.begin(), l.end(), v);
+        if (it != l.end() && *it == v) return false;
+        l.insert(it, v);
+        total++;
+        return true;
+    }
+    bool apagar(Idx u, Idx v) {
+        Vetor<Idx>& l = listas[u];
+        auto it = lower_bound(l.begin(), l.end(), v);
+        if (it == l.end() || *it != v) return false;
+        l.erase(it);
+        total--;
+        return true;
+    }
+    // Esvazia a lista de u; quem apaga u das listas dos vizinhos é o chamador.
+    void esvaziar(Idx u) {
+        total -= listas[u].size();
+        listas[u].clear();
+    }
+};
+
+// Pela construção CSR (ordenada, sem repetição), copiada lista a lista.
+template <class Idx>
+void construirGrafo(const Plano& p, Grafo<Idx, ListaDinamica<Idx>>& g) {
+    Grafo<Idx> csr(g.suc.listas.get_allocator().resource());
+    construirGrafo(p, csr);
+    g.qntV = csr.qntV;
+    for (int lado = 0; lado < 2; lado++) {
+        const ListaAdj<Idx>& de = lado ? csr.pred : csr.suc;
+        ListaDinamica<Idx>& para = lado ? g.pred : g.suc;
+        para.redimensionar(g.qntV);
+        for (Idx u = 0; u < g.qntV; u++)
+            para.listas[u].assign(de.alvo.begin() + de.inicio[u], de.alvo.begin() + de.inicio[u + 1]);
+        para.total = de.arestas();
+    }
 }
 
-// ---------------- main ----------------
-int main() {
-    cout << "=== PERT/CPM (vértices = atividades) ===\n\n";
-    int n;
-    cout << "Quantidade de atividades: ";
-    while (!(cin >> n) || n <= 0) {
-        cout << "Entrada inválida. Digite um inteiro > 0: ";
-        cin.clear();
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    }
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-
-    vector<string> rotulos(n);
-    vector<int> dur(n, 0);
-    vector<vector<int>> preds_raw(n);
-
-    cout << "\nDigite os rótulos:\n";
-    for (int i = 0; i < n; i++) {
-        cout << "Rótulo atividade " << i+1 << ": ";
-        cin >> rotulos[i];
-    }
-
-    cout << "\nDigite as durações:\n";
-    for (int i = 0; i < n; i++) {
-        cout << "Duração de " << rotulos[i] << ": ";
-        while (!(cin >> dur[i]) || dur[i] < 0) {
-            cout << "Duração inválida. Digite inteiro >= 0: ";
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        }
-    }
-
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-
-    cout << "\nDigite os predecessores para cada atividade.\nExemplo: A,B ou '-' se nenhum.\n";
-    for (int i = 0; i < n; i++) {
-        cout << "Predecessores de " << rotulos[i] << " : ";
-        string linha;
-        getline(cin, linha);
-        if (linha.empty()) { i--; continue; }
-        vector<int> pl = lerPredecessores(linha, rotulos);
-        bool valido = true;
-        for (int x : pl) if (x == -1) { valido = false; break; }
-        if (!valido) {
-            cout << "Um ou mais rótulos não existem. Digite novamente.\n";
-            i--;
-            continue;
+// ---------------- faixas (vista sobre memória contígua) ----------------
+// Ponteiro + tamanho, como std::span do C++20: a API de cálculo escreve na
+// memória de quem chama, seja Vetor, vector, array ou buffer cru.
+template <class T>
+struct Faixa {
+    T* dados = nullptr;
+    size_t tam = 0;
+
+    Faixa() = default;
+    Faixa(T* p, size_t n) : dados(p), tam(n) {}
+    template <class C, class = decltype(declval<C&>().data())>
+    Faixa(C& c) : dados(c.data()), tam(c.size()) {}
+
+    T& operator[](size_t i) const { return dados[i]; }
+    size_t size() const { return tam; }
+    T* begin() const { return dados; }
+    T* end() const { return dados + tam; }
+};
+
+// Durações por vértice, só leitura: uma faixa comum ou, na rede repetida, as m durações
+// do modelo vistas como m * unidades posições (o vértice v é a atividade v % m da
+// unidade v / m), sem vetor expandido. Sem repetição o acesso não divide.
+template <class Tempo>
+struct Duracoes {
+    const Tempo* dados = nullptr;
+    size_t m = 0, tam = 0;
+
+    Duracoes() = default;
+    Duracoes(Faixa<const Tempo> f) : dados(f.dados), m(f.tam), tam(f.tam) {}
+    template <class C, class = decltype(declval<const C&>().data())>
+    Duracoes(const C& c) : dados(c.data()), m(c.size()), tam(c.size()) {}
+    Duracoes(Faixa<const Tempo> modelo, uint64_t unidades) : dados(modelo.dados), m(modelo.tam), tam(modelo.tam * unidades) {}
+
+    Tempo operator[](size_t i) const { return dados[i < m ? i : i % m]; }
+    size_t size() const { return tam; }
+};
+
+// ---------------- ordenação topológica (Kahn) ----------------
+// 'ordem' serve também de fila: o próximo a sair é ordem[h], quem fica pronto
+// entra no fim. 'indeg' é rascunho. Ambos com g.qntV posições. Se houver ciclo,
+// retorna false.
+template <class Idx, class Adj>
+bool topoOrdenacao(const Grafo<Idx, Adj>& g, Faixa<Idx> ordem, Faixa<Desl<Idx>> indeg) {
+    Idx qntV = g.qntV;
+    size_t fim = 0;
+    for (Idx i = 0; i < qntV; i++) {
+        indeg[i] = (Desl<Idx>)g.pred.grau(i);
+        if (indeg[i] == 0) ordem[fim++] = i;
+    }
+    for (size_t h = 0; h < fim; h++)
+        g.suc.paraCada(ordem[h], [&](Idx v) {
+            if (--indeg[v] == 0) ordem[fim++] = v;
+        });
+    return fim == (size_t)qntV;
+}
+
+// ---------------- cálculo PERT/CPM ----------------
+// Espaço de trabalho reutilizável: preparar(g) dimensiona os rascunhos e guarda a
+// ordem topológica; calcular() roda as duas passadas escrevendo nas faixas de quem
+// chama. Em laços de what-if sobre o mesmo grafo (só durações mudam), cada
+// calcular() é O(V+E) sem nenhuma alocação. Se as arestas mudarem, preparar de novo.
+template <class Idx, class Tempo>
+class EspacoCPM {
+public:
+    explicit EspacoCPM(pmr::memory_resource* mem = pmr::get_default_resource()) : ordem(mem), indeg(mem) {}
+
+    // Retorna false se houver ciclo; aloca só quando o grafo cresce.
+    template <class Adj>
+    bool preparar(const Grafo<Idx, Adj>& g) {
+        ordem.resize(g.qntV);
+        indeg.resize(g.qntV);
+        pronto = topoOrdenacao(g, Faixa<Idx>(ordem), Faixa<Desl<Idx>>(indeg));
+        return pronto;
+    }
+    bool aciclico() const { return pronto; }
+    const Vetor<Idx>& ordemTopologica() const { return ordem; }
+
+    // Faixas com g.qntV posições; 'g' é o mesmo grafo de preparar().
+    template <class Adj>
+    bool calcular(const Grafo<Idx, Adj>& g, Duracoes<Tempo> dur,
+                  Faixa<Tempo> ES, Faixa<Tempo> EF, Faixa<Tempo> LS, Faixa<Tempo> LF, Tempo& duracaoProjeto) const {
+        if (!pronto) return false;
+
+        // -------- forward (ES/EF) --------
+        duracaoProjeto = Tempo{};
+        for (Idx u : ordem) duracaoProjeto = max(duracaoProjeto, ida(g, u, dur, ES, EF));
+
+        // -------- backward (LS/LF) --------
+        for (size_t idx = ordem.size(); idx-- > 0;) volta(g, ordem[idx], dur, LS, LF, duracaoProjeto);
+        return true;
+    }
+
+    // Passo de um vértice em cada passada, com os vizinhos já calculados; a propagação
+    // incremental da sessão usa os mesmos. ida retorna o EF.
+    template <class Adj>
+    static Tempo ida(const Grafo<Idx, Adj>& g, Idx u, Duracoes<Tempo> dur, Faixa<Tempo> ES, Faixa<Tempo> EF) {
+        Tempo maxEfPred{};
+        g.pred.paraCada(u, [&](Idx p) { maxEfPred = max(maxEfPred, EF[p]); });
+        ES[u] = maxEfPred;
+        return EF[u] = ES[u] + dur[u];
+    }
+    template <class Adj>
+    static void volta(const Grafo<Idx, Adj>& g, Idx u, Duracoes<Tempo> dur, Faixa<Tempo> LS, Faixa<Tempo> LF,
+                      Tempo duracaoProjeto) {
+        Tempo lf = TempoTraits<Tempo>::maximo();
+        bool temSucessor = false;
+        g.suc.paraCada(u, [&](Idx v) { lf = min(lf, LS[v]); temSucessor = true; });
+        LF[u] = temSucessor ? lf : duracaoProjeto;
+        LS[u] = LF[u] - dur[u];
+    }
+
+private:
+    Vetor<Idx> ordem;
+    Vetor<Desl<Idx>> indeg;
+    bool pronto = false;
+};
+
+// Cálculo avulso: prepara um espaço só para esta chamada e dimensiona os resultados.
+template <class Idx, class Adj, class Tempo>
+bool calcularPERT(const Grafo<Idx, Adj>& g, Duracoes<Tempo> dur,
+                  Vetor<Tempo>& ES, Vetor<Tempo>& EF, Vetor<Tempo>& LS, Vetor<Tempo>& LF, Tempo& duracaoProjeto) {
+    EspacoCPM<Idx, Tempo> espaco(ES.get_allocator().resource());
+    if (!espaco.preparar(g)) return false;
+    ES.resize(g.qntV);
+    EF.resize(g.qntV);
+    LS.resize(g.qntV);
+    LF.resize(g.qntV);
+    return espaco.calcular(g, dur, Faixa<Tempo>(ES), Faixa<Tempo>(EF),
+                           Faixa<Tempo>(LS), Faixa<Tempo>(LF), duracaoProjeto);
+}
+
+// Reprogramação com progresso (atualizações de status): atividades concluídas ficam
+// com as datas reais; em andamento, com o início real e o restante em lógica retida
+// (EF = restante depois da data de status e do EF dos predecessores); não iniciadas,
+// com ES >= data de status. Só a fronteira não concluída passa pelas
+// duas passadas: 'pendentes' é a ordem topológica restrita a ela e encolhe à medida que
+// as atividades concluem. Cada atualização custa O(pendentes + suas arestas), mais uma
+// varredura linear que copia as datas das concluídas. LF de uma concluída é a data de
+// status ou o início real de um sucessor já iniciado, o que vier antes: ela podia ter
+// acabado até ali sem mudar nada do que falta (folga zero = segura o trabalho restante).
+// Na volta, um sucessor em andamento limita pelo que lhe resta (LF - restante), não pelo
+// LS planejado, que inclui o tempo já gasto; um sucessor concluído não limita.
+// O progresso só avança: concluída não volta, e o grafo é o mesmo de preparar().
+// preparar() de novo (grafo alterado ou progresso refeito do zero) recomeça tudo,
+// reaproveitando o espaço de ordenação e os vetores da vez anterior.
+template <class Idx, class Tempo>
+class ReprogramacaoCPM {
+public:
+    enum Situacao : uint8_t { NAO_INICIADA, EM_ANDAMENTO, CONCLUIDA };
+
+    explicit ReprogramacaoCPM(pmr::memory_resource* mem = pmr::get_default_resource())
+        : espaco(mem), situacao(mem), inicio(mem), fim(mem), restante(mem), inicioSuc(mem), pendentes(mem),
+          concluidas(mem) {}
+
+    template <class Adj>
+    bool preparar(const Grafo<Idx, Adj>& g) {
+        if (!espaco.preparar(g)) return false;
+        pendentes.assign(espaco.ordemTopologica().begin(), espaco.ordemTopologica().end());
+        situacao.assign(g.qntV, NAO_INICIADA);
+        inicio.assign(g.qntV, Tempo{});
+        fim.assign(g.qntV, Tempo{});
+        restante.assign(g.qntV, Tempo{});
+        inicioSuc.assign(g.qntV, TempoTraits<Tempo>::maximo());
+        concluidas.clear();
+        saindo = 0;
+        fimConcluidas = Tempo{};
+        return true;
+    }
+
+    Situacao estado(Idx v) const { return (Situacao)situacao[v]; }
+    // true se (s, ini, f) só faz o progresso de v avançar: iniciar/concluir bastam, sem
+    // preparar de novo. O início real não muda depois de registrado, nem a concluída.
+    bool avanca(Idx v, Situacao s, Tempo ini, Tempo f) const {
+        if (situacao[v] == NAO_INICIADA) return true;
+        if (inicio[v] != ini) return false;
+        return situacao[v] == EM_ANDAMENTO ? s != NAO_INICIADA : s == CONCLUIDA && fim[v] == f;
+    }
+    size_t quantidadePendentes() const { return pendentes.size() - saindo; }
+    size_t quantidadeConcluidas() const { return concluidas.size(); }
+
+    template <class Adj>
+    void iniciar(const Grafo<Idx, Adj>& g, Idx v, Tempo ini, Tempo rest) {
+        if (situacao[v] == CONCLUIDA) return;
+        if (situacao[v] == NAO_INICIADA) registrarInicio(g, v, ini);
+        situacao[v] = EM_ANDAMENTO;
+        inicio[v] = ini;
+        restante[v] = rest;
+    }
+    template <class Adj>
+    void concluir(const Grafo<Idx, Adj>& g, Idx v, Tempo ini, Tempo f) {
+        if (situacao[v] == CONCLUIDA) return;
+        if (situacao[v] == NAO_INICIADA) registrarInicio(g, v, ini);
+        situacao[v] = CONCLUIDA;
+        inicio[v] = ini;
+        fim[v] = f;
+        concluidas.push_back(v);
+        saindo++;   // sai de 'pendentes' na próxima passada
+        fimConcluidas = max(fimConcluidas, f);
+    }
+
+    // Mesmas faixas de EspacoCPM::calcular; 'dur' é a duração planejada.
+    template <class Adj>
+    void calcular(const Grafo<Idx, Adj>& g, Duracoes<Tempo> dur, Tempo dataStatus,
+                  Faixa<Tempo> ES, Faixa<Tempo> EF, Faixa<Tempo> LS, Faixa<Tempo> LF, Tempo& duracaoProjeto) {
+        for (Idx c : concluidas) {
+            ES[c] = inicio[c];
+            EF[c] = fim[c];
+            LF[c] = min(dataStatus, inicioSuc[c]);
+            LS[c] = LF[c] - (EF[c] - ES[c]);
+        }
+
+        // -------- forward (ES/EF), retirando as que concluíram --------
+        duracaoProjeto = concluidas.empty() ? Tempo{} : fimConcluidas;
+        size_t k = 0;
+        for (size_t i = 0; i < pendentes.size(); i++) {
+            Idx u = pendentes[i];
+            if (situacao[u] == CONCLUIDA) continue;
+            pendentes[k++] = u;
+            Tempo es = dataStatus;
+            g.pred.paraCada(u, [&](Idx p) { es = max(es, EF[p]); });
+            if (situacao[u] == EM_ANDAMENTO) {
+                ES[u] = inicio[u];
+                EF[u] = es + restante[u];
+            } else {
+                ES[u] = es;
+                EF[u] = es + dur[u];
+            }
+            duracaoProjeto = max(duracaoProjeto, EF[u]);
+        }
+        pendentes.resize(k);
+        saindo = 0;
+
+        // -------- backward (LS/LF); sucessor concluído fora de sequência não limita --------
+        for (size_t i = pendentes.size(); i-- > 0;) {
+            Idx u = pendentes[i];
+            Tempo lf = TempoTraits<Tempo>::maximo();
+            bool temSucessor = false;
+            g.suc.paraCada(u, [&](Idx v) {
+                if (situacao[v] == CONCLUIDA) return;
+                lf = min(lf, situacao[v] == EM_ANDAMENTO ? LF[v] - restante[v] : LS[v]);
+                temSucessor = true;
+            });
+            LF[u] = temSucessor ? lf : duracaoProjeto;
+            LS[u] = LF[u] - (EF[u] - ES[u]);
         }
-        preds_raw[i] = pl;
     }
 
-    int** mat = criarMatriz(n);
-    for (int i = 0; i < n; i++)
-        for (int p : preds_raw[i])
-            mat[p][i] = 1;
+private:
+    EspacoCPM<Idx, Tempo> espaco;   // só a ordenação topológica de preparar
+    Vetor<uint8_t> situacao;
+    Vetor<Tempo> inicio, fim, restante;
+    Vetor<Tempo> inicioSuc;      // menor início real entre os sucessores já iniciados
+    Vetor<Idx> pendentes;        // ordem topológica das não concluídas
+    Vetor<Idx> concluidas;
+    size_t saindo = 0;
+    Tempo fimConcluidas{};
 
-    cout << "\nGrafo construído. Matriz de adjacência:\n";
-    cout << "   ";
-    for (int j = 0; j < n; j++) cout << j << " ";
-    cout << "\n";
-    for (int i = 0; i < n; i++) {
-        cout << i << ": ";
-        for (int j = 0; j < n; j++) cout << mat[i][j] << " ";
-        cout << "   (" << rotulos[i] << ", d=" << dur[i] << ")\n";
+    template <class Adj>
+    void registrarInicio(const Grafo<Idx, Adj>& g, Idx v, Tempo ini) {
+        g.pred.paraCada(v, [&](Idx p) { inicioSuc[p] = min(inicioSuc[p], ini); });
     }
+};
 
-    vector<int> ES, EF, LS, LF;
-    int durProjeto = 0;
-    bool ok = calcularPERT(mat, n, rotulos, dur, ES, EF, LS, LF, durProjeto);
-    if (!ok) {
-        cout << "\nErro: o grafo possui ciclo(s).\n";
-        liberarMatriz(mat, n);
-        return 0;
+// ---------------- CPM em memória externa ----------------
+// Para grafos cujas arestas não cabem na RAM. Modelo semiexterno: os vetores por
+// vértice (durações, ES/EF/LS/LF, graus, ordem) ficam em memória; as arestas ficam
+// em disco e só passam por buffers limitados pelo orçamento.
+//   1. ordenação externa das arestas por origem (corridas ordenadas + intercalação);
+//   2. Kahn por níveis: a cada nível, as listas das origens prontas são lidas em
+//      ordem crescente de deslocamento e regravadas num bloco do nível;
+//   3. ida: os blocos em ordem, cada um lido sequencialmente;
+//   4. volta: os blocos em ordem inversa, cada um lido sequencialmente.
+// Todas as arestas de uma origem caem no bloco do nível dela, então ao ler o bloco
+// k as origens já têm ES final (ida) e os destinos, LS final (volta). O resultado
+// é o mesmo de calcularPERT.
+
+struct EstatExterno {
+    uint64_t lidos = 0, escritos = 0;   // bytes de arestas
+    size_t corridas = 0, niveis = 0;
+};
+
+// Registro do arquivo de entrada: (predecessor, sucessor) em 64 bits, para quem grava
+// durante a leitura não depender do Idx escolhido depois.
+using ArestaArquivo = pair<uint64_t, uint64_t>;
+
+// Registros de tamanho fixo em arquivo temporário. O mesmo buffer serve à escrita
+// (acumula até descarregar) e à leitura (janela [lidoIni, lidoIni + lidoN)).
+template <class T>
+class ArquivoRegistros {
+public:
+    ArquivoRegistros(size_t capacidade, EstatExterno& est) : arq(tmpfile()), buf(max<size_t>(capacidade, 1)), est(est) {
+        if (arq) setvbuf(arq, nullptr, _IONBF, 0);   // o buffer é o nosso
     }
+    ~ArquivoRegistros() { if (arq) fclose(arq); }
+    ArquivoRegistros(const ArquivoRegistros&) = delete;
+    ArquivoRegistros& operator=(const ArquivoRegistros&) = delete;
 
-    vector<int> folga(n);
-    for (int i = 0; i < n; i++) folga[i] = LS[i] - ES[i];
+    bool ok() const { return arq != nullptr && !erro; }
+    uint64_t tamanho() const { return total + pendentes; }
 
-    cout << "\nTabela PERT/CPM:\n";
-    cout << "Atv | Dur | ES | EF | LS | LF | Folga\n";
-    cout << "-------------------------------------------\n";
-    for (int i = 0; i < n; i++) {
-        printf("%-3s | %-3d | %-3d | %-3d | %-3d | %-3d | %-3d\n",
-               rotulos[i].c_str(), dur[i], ES[i], EF[i], LS[i], LF[i], folga[i]);
+    void capacidade(size_t c) {
+        descarregar();
+        buf.assign(max<size_t>(c, 1), T{});
+        lidoN = 0;
     }
-    cout << "-------------------------------------------\n";
-    cout << "Duração mínima: " << durProjeto << "\n";
 
-    cout << "\nAtividades críticas (folga total = 0):\n";
-    vector<int> criticas;
-    for (int i = 0; i < n; i++) if (folga[i] == 0) {
-        criticas.push_back(i);
-        cout << rotulos[i] << " ";
+    void escrever(const T& r) {
+        if (pendentes == buf.size()) descarregar();
+        buf[pendentes++] = r;
+    }
+    void escrever(const T* p, size_t n) {
+        descarregar();
+        if (!ok() || fseeko(arq, (off_t)(total * sizeof(T)), SEEK_SET) != 0 || fwrite(p, sizeof(T), n, arq) != n) erro = true;
+        est.escritos += n * sizeof(T);
+        total += n;
+    }
+    void descarregar() {
+        lidoN = 0;   // a janela de leitura deixa de valer
+        if (!pendentes) return;
+        if (!ok() || fseeko(arq, (off_t)(total * sizeof(T)), SEEK_SET) != 0 ||
+            fwrite(buf.data(), sizeof(T), pendentes, arq) != pendentes) erro = true;
+        est.escritos += pendentes * sizeof(T);
+        total += pendentes;
+        pendentes = 0;
     }
-    if (criticas.empty()) cout << "(nenhuma)\n";
-    cout << "\n";
 
-    vector<int> caminhoCrit = encontrarCaminhoCritico(mat, n, ES, EF, LS, LF);
-    if (!caminhoCrit.empty()) {
-        cout << "Caminho crítico: ";
-        for (int i = 0; i < (int)caminhoCrit.size(); i++) {
-            if (i) cout << " -> ";
-            cout << rotulos[caminhoCrit[i]];
+    // Chama f(r) para os registros [a, b). Se a não estiver na janela, lê uma nova
+    // a partir de janIni (se janIni <= a estiver a menos de uma janela de a) e de no
+    // máximo max(b, janFim) - início registros: quem chama escolhe a janela para que
+    // as próximas consultas caiam nela (para trás, para frente ou só o necessário).
+    template <class F>
+    void percorrer(uint64_t a, uint64_t b, F&& f, uint64_t janIni = UINT64_MAX, uint64_t janFim = UINT64_MAX) {
+        if (pendentes) descarregar();
+        while (a < b && ok()) {
+            if (a < lidoIni || a >= lidoIni + lidoN) {
+                uint64_t s = (janIni <= a && a - janIni < buf.size()) ? janIni : a;
+                uint64_t n = min<uint64_t>({buf.size(), total - s, max(b, janFim) - s});
+                if (fseeko(arq, (off_t)(s * sizeof(T)), SEEK_SET) != 0) { erro = true; return; }
+                lidoIni = s;
+                lidoN = fread(buf.data(), sizeof(T), (size_t)n, arq);
+                est.lidos += lidoN * sizeof(T);
+                if (a >= lidoIni + lidoN) { erro = true; return; }
+                janIni = UINT64_MAX;
+            }
+            uint64_t lim = min(b, lidoIni + lidoN);
+            for (; a < lim; a++) f(buf[a - lidoIni]);
         }
-        cout << "\n";
-    } else {
-        cout << "Não foi possível extrair um caminho crítico linear.\n";
     }
+    // leitura sequencial a partir do início
+    bool proximo(T& r) {
+        if (cursor >= tamanho()) return false;
+        percorrer(cursor, cursor + 1, [&](const T& x) { r = x; });
+        cursor++;
+        return ok();
+    }
+    void voltarAoInicio() { cursor = 0; }
 
-    gerarJSON_vis(mat, n, rotulos, dur, caminhoCrit, ES, EF, LS, LF);
-    cout << "Arquivo 'grafo.json' gerado.\n";
+private:
+    FILE* arq;
+    vector<T> buf;
+    EstatExterno& est;
+    size_t pendentes = 0;
+    uint64_t total = 0, lidoIni = 0, lidoN = 0, cursor = 0;
+    bool erro = false;
+};
 
-    liberarMatriz(mat, n);
-    return 0;
+// Ordena as arestas por origem com 'capacidade' registros em memória por vez;
+// conta no caminho os deslocamentos de cada origem e os graus de entrada.
+template <class Idx>
+unique_ptr<ArquivoRegistros<pair<Idx, Idx>>>
+ordenarPorOrigem(FILE* entrada, size_t capacidade, EstatExterno& est,
+                 Vetor<uint64_t>& inicio, Vetor<uint64_t>& grauEnt, bool& erro) {
+    using Aresta = pair<Idx, Idx>;
+    using Arquivo = ArquivoRegistros<Aresta>;
+    const size_t MIN_BUF = 1024;   // registros por leitor na intercalação
+    uint64_t qntV = grauEnt.size();
+
+    // corridas ordenadas do tamanho do orçamento; cada registro vira Idx ao entrar no bloco
+    vector<unique_ptr<Arquivo>> corridas;
+    vector<Aresta> bloco(capacidade);
+    vector<ArestaArquivo> lidas(min<size_t>(capacidade, 4096));
+    rewind(entrada);
+    while (true) {
+        size_t n = 0;
+        for (size_t pedido = 1; n < capacidade && pedido;) {
+            pedido = min(lidas.size(), capacidade - n);
+            size_t k = fread(lidas.data(), sizeof(ArestaArquivo), pedido, entrada);
+            est.lidos += k * sizeof(ArestaArquivo);
+            for (size_t i = 0; i < k; i++) {
+                if (lidas[i].first >= qntV || lidas[i].second >= qntV) { erro = true; return nullptr; }
+                inicio[lidas[i].first + 1]++;
+                grauEnt[lidas[i].second]++;
+                bloco[n++] = Aresta((Idx)lidas[i].first, (Idx)lidas[i].second);
+            }
+            if (k < pedido) pedido = 0;   // fim do arquivo
+        }
+        if (n == 0 && !corridas.empty()) break;
+        sort(bloco.begin(), bloco.begin() + n);
+        corridas.push_back(make_unique<Arquivo>(1, est));
+        corridas.back()->escrever(bloco.data(), n);
+        erro |= !corridas.back()->ok();
+        if (n < capacidade) break;
+    }
+    erro |= ferror(entrada) != 0;
+    bloco = vector<Aresta>();
+    lidas = vector<ArestaArquivo>();
+    for (size_t u = 1; u < inicio.size(); u++) inicio[u] += inicio[u - 1];
+    est.corridas = corridas.size();
+
+    // intercalação em rodadas de até 'leque' corridas, para o orçamento valer com muitas corridas
+    size_t leque = max<size_t>(2, capacidade / MIN_BUF - 1);
+    while (corridas.size() > 1 && !erro) {
+        vector<unique_ptr<Arquivo>> proximas;
+        for (size_t g = 0; g < corridas.size(); g += leque) {
+            size_t fimG = min(corridas.size(), g + leque);
+            size_t porLeitor = max(MIN_BUF, capacidade / (fimG - g + 1));
+            auto saida = make_unique<Arquivo>(porLeitor, est);
+            using Item = pair<Aresta, size_t>;
+            priority_queue<Item, vector<Item>, greater<Item>> heap;
+            for (size_t i = g; i < fimG; i++) {
+                corridas[i]->capacidade(porLeitor);
+                Aresta x;
+                if (corridas[i]->proximo(x)) heap.emplace(x, i);
+            }
+            while (!heap.empty()) {
+                auto [x, i] = heap.top();
+                heap.pop();
+                saida->escrever(x);
+                Aresta y;
+                if (corridas[i]->proximo(y)) heap.emplace(y, i);
+            }
+            saida->descarregar();
+            for (size_t i = g; i < fimG; i++) { erro |= !corridas[i]->ok(); corridas[i].reset(); }
+            erro |= !saida->ok();
+            proximas.push_back(move(saida));
+        }
+        corridas = move(proximas);
+    }
+    return move(corridas[0]);
+}
+
+// 'arestas': arquivo de ArestaArquivo, em qualquer ordem; repetidas não alteram o
+// resultado. 'orcamento' limita os bytes de arestas em
+// memória. Retorna false se houver ciclo ou erro de E/S (erroES indica qual).
+template <class Idx, class Tempo>
+bool calcularPERTExterno(FILE* arestas, Idx qntV, Duracoes<Tempo> dur, size_t orcamento,
+                         Vetor<Tempo>& ES, Vetor<Tempo>& EF, Vetor<Tempo>& LS, Vetor<Tempo>& LF,
+                         Tempo& duracaoProjeto, EstatExterno& est, bool& erroES) {
+    using Aresta = pair<Idx, Idx>;
+    pmr::memory_resource* mem = ES.get_allocator().resource();
+    const uint64_t SALTO = 4096 / sizeof(Aresta);   // até uma página lida à toa vale mais que um posicionamento
+    size_t capacidade = max<size_t>(orcamento / sizeof(Aresta), 4096);
+    erroES = false;
+
+    // -------- 1. arestas por origem --------
+    Vetor<uint64_t> inicio((size_t)qntV + 1, 0, mem), grauEnt(qntV, 0, mem);
+    auto porOrigem = ordenarPorOrigem<Idx>(arestas, capacidade, est, inicio, grauEnt, erroES);
+    if (erroES) return false;
+
+    // -------- 2. Kahn por níveis, gravando um bloco por nível --------
+    // metade do orçamento para ler as listas, metade para gravar os blocos
+    porOrigem->capacidade(capacidade / 2);
+    ArquivoRegistros<Aresta> blocos(capacidade / 2, est);
+    Vetor<Idx> ordem(mem);             // vértices em ordem de nível
+    Vetor<uint64_t> nivelVert(mem);    // ordem[nivelVert[k] .. nivelVert[k+1]) = nível k
+    Vetor<uint64_t> nivelAresta(mem);  // bloco k = registros [nivelAresta[k], nivelAresta[k+1])
+    ordem.reserve(qntV);
+    for (Idx i = 0; i < qntV; i++) if (grauEnt[i] == 0) ordem.push_back(i);
+    size_t ini = 0;
+    while (ini < ordem.size()) {
+        size_t fim = ordem.size();
+        nivelVert.push_back(ini);
+        nivelAresta.push_back(blocos.tamanho());
+        sort(ordem.begin() + ini, ordem.end());   // deslocamentos crescentes: leitura só para frente
+        size_t alcance = ini;   // janela cobre as listas do nível até ordem[alcance - 1]
+        for (size_t h = ini; h < fim; h++) {
+            Idx u = ordem[h];
+            // a janela junta as próximas listas do nível enquanto o trecho pulado entre
+            // elas for curto; lacuna maior sai mais barata como um novo posicionamento
+            alcance = max(alcance, h + 1);
+            while (alcance < fim && inicio[ordem[alcance]] - inicio[ordem[alcance - 1] + 1] <= SALTO &&
+                   inicio[ordem[alcance] + 1] - inicio[u] <= capacidade / 2) alcance++;
+            porOrigem->percorrer(inicio[u], inicio[u + 1], [&](const Aresta& a) {
+                blocos.escrever(a);
+                if (--grauEnt[a.second] == 0) ordem.push_back(a.second);
+            }, inicio[u], inicio[ordem[alcance - 1] + 1]);
+        }
+        ini = fim;
+    }
+    nivelVert.push_back(ordem.size());
+    nivelAresta.push_back(blocos.tamanho());
+    est.niveis = nivelVert.size() - 1;
+    erroES = !porOrigem->ok() || !blocos.ok();
+    porOrigem.reset();
+    if (erroES || ordem.size() != (size_t)qntV) return false;
+    blocos.capacidade(capacidade);
+
+    // -------- 3. ida (ES/EF) --------
+    ES.assign(qntV, Tempo{});
+    EF.assign(qntV, Tempo{});
+    for (size_t k = 0; k < est.niveis; k++) {
+        for (uint64_t h = nivelVert[k]; h < nivelVert[k + 1]; h++) {
+            Idx u = ordem[h];
+            EF[u] = ES[u] + dur[u];
+        }
+        blocos.percorrer(nivelAresta[k], nivelAresta[k + 1], [&](const Aresta& a) {
+            ES[a.second] = max(ES[a.second], EF[a.first]);
+        });
+    }
+    duracaoProjeto = Tempo{};
+    for (Idx i = 0; i < qntV; i++) duracaoProjeto = max(duracaoProjeto, EF[i]);
+
+    // -------- 4. volta (LS/LF) --------
+    // janela terminando no fim do bloco: os blocos anteriores, pequenos, caem nela
+    LF.assign(qntV, TempoTraits<Tempo>::maximo());
+    LS.assign(qntV, Tempo{});
+    for (size_t k = est.niveis; k-- > 0;) {
+        uint64_t a = nivelAresta[k], b = nivelAresta[k + 1];
+        uint64_t janIni = (b - a <= capacidade) ? (b > capacidade ? b - capacidade : 0) : a;
+        blocos.percorrer(a, b, [&](const Aresta& e) {
+            LF[e.first] = min(LF[e.first], LS[e.second]);
+        }, janIni, b);
+        for (uint64_t h = nivelVert[k]; h < nivelVert[k + 1]; h++) {
+            Idx u = ordem[h];
+            if (inicio[u] == inicio[u + 1]) LF[u] = duracaoProjeto;
+            LS[u] = LF[u] - dur[u];
+        }
+    }
+    erroES = !blocos.ok();
+    return !erroES;
+}
+
+// ---------------- CPM distribuído (coordenador + trabalhadores) ----------------
+// O grafo é dividido em partes com poucas arestas de corte e cada parte vai para
+// um processo trabalhador, ligado ao coordenador por TCP. O coordenador não ordena
+// o grafo: cada trabalhador acha a ordem topológica da sua parte por Kahn, em
+// rodadas em que o coordenador só repassa quais vértices de fronteira já saíram da
+// ordem das outras partes. Se as rodadas param com vértices pendentes em alguma
+// parte, há ciclo (local ou atravessando partes). Depois, cada passada local é uma
+// varredura só nessa ordem. Ida em rodadas: o coordenador manda a cada parte o EF atual dos predecessores
+// externos, todas recalculam em paralelo e devolvem o EF dos vértices com
+// sucessores fora; repete até nenhum valor de fronteira mudar. A volta é igual com
+// LS. Na ida os valores só sobem a partir de 0 e na volta só descem a partir da
+// duração do projeto; num DAG o ponto fixo é único, então o resultado é o mesmo
+// de calcularPERT. Os valores trafegam na representação nativa: coordenador e
+// trabalhadores rodam o mesmo binário na mesma arquitetura.
+
+struct EstatDistribuido {
+    size_t partes = 0, rodadasOrdem = 0, rodadasIda = 0, rodadasVolta = 0;
+    uint64_t arestasCorte = 0, bytes = 0;   // bytes trocados com os trabalhadores
+};
+
+// Mensagens com prefixo de tamanho sobre um socket: montadas em 'saida' e lidas de
+// 'entrada', então uma resposta pode ser montada enquanto o pedido é lido.
+class Canal {
+public:
+    explicit Canal(int fd = -1) : fd(fd) {}
+    ~Canal() { if (fd >= 0) close(fd); }
+    Canal(Canal&& o) noexcept : fd(exchange(o.fd, -1)), saida(move(o.saida)), entrada(move(o.entrada)), pos(o.pos), trafego(o.trafego), erro(o.erro) {}
+    Canal(const Canal&) = delete;
+    Canal& operator=(const Canal&) = delete;
+
+    bool ok() const { return fd >= 0 && !erro; }
+    uint64_t bytes() const { return trafego; }
+
+    template <class T>
+    void por(const T& x) {
+        static_assert(is_trivially_copyable_v<T>, "só tipos triviais vão crus pelo canal");
+        const char* p = reinterpret_cast<const char*>(&x);
+        saida.insert(saida.end(), p, p + sizeof(T));
+    }
+    template <class C>
+    void porVetor(const C& c) {
+        por<uint64_t>(c.size());
+        const char* p = reinterpret_cast<const char*>(c.data());
+        saida.insert(saida.end(), p, p + c.size() * sizeof(c[0]));
+    }
+    bool enviar() {
+        uint64_t n = saida.size();
+        bool r = escreverTudo(&n, sizeof(n)) && escreverTudo(saida.data(), n);
+        saida.clear();
+        return r;
+    }
+
+    bool receber() {
+        uint64_t n;
+        entrada.clear();
+        pos = 0;
+        if (!lerTudo(&n, sizeof(n))) return false;
+        entrada.resize(n);
+        return lerTudo(entrada.data(), n);
+    }
+    template <class T>
+    bool tirar(T& x) {
+        if (entrada.size() - pos < sizeof(T)) return erro = true, false;
+        memcpy(&x, entrada.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+    template <class C>
+    bool tirarVetor(C& c) {
+        uint64_t n;
+        if (!tirar(n) || (entrada.size() - pos) / sizeof(c[0]) < n) return erro = true, false;
+        c.resize(n);
+        memcpy(c.data(), entrada.data() + pos, n * sizeof(c[0]));
+        pos += n * sizeof(c[0]);
+        return true;
+    }
+
+private:
+    bool escreverTudo(const void* p, size_t n) {
+        for (const char* q = (const char*)p; n;) {
+            ssize_t k = send(fd, q, n, MSG_NOSIGNAL);
+            if (k < 0 && errno == EINTR) continue;
+            if (k <= 0) return erro = true, false;
+            q += k;
+            n -= k;
+            trafego += k;
+        }
+        return true;
+    }
+    bool lerTudo(void* p, size_t n) {
+        for (char* q = (char*)p; n;) {
+            ssize_t k = recv(fd, q, n, 0);
+            if (k < 0 && errno == EINTR) continue;
+            if (k <= 0) return erro = true, false;
+            q += k;
+            n -= k;
+            trafego += k;
+        }
+        return true;
+    }
+
+    int fd;
+    vector<char> saida, entrada;
+    size_t pos = 0;
+    uint64_t trafego = 0;
+    bool erro = false;
+};
+
+enum ComandoParte : uint8_t { PARTE_ORDEM, PARTE_IDA, PARTE_VOLTA, PARTE_FIM };
+
+// Socket TCP ouvindo em 'porta' (0 = qualquer livre, devolvida em 'porta'); só na
+// interface de loopback se 'local'. Retorna -1 em caso de erro.
+int ouvirTCP(uint16_t& porta, bool local, int fila) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    int um = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+    sockaddr_in end{};
+    end.sin_family = AF_INET;
+    end.sin_addr.s_addr = htonl(local ? INADDR_LOOPBACK : INADDR_ANY);
+    end.sin_port = htons(porta);
+    socklen_t tam = sizeof(end);
+    if (bind(fd, (sockaddr*)&end, sizeof(end)) != 0 || listen(fd, fila) != 0 ||
+        getsockname(fd, (sockaddr*)&end, &tam) != 0) {
+        close(fd);
+        return -1;
+    }
+    porta = ntohs(end.sin_port);
+    return fd;
+}
+
+int conectarTCP(const string& host, const string& porta) {
+    addrinfo dica{}, *lista = nullptr;
+    dica.ai_family = AF_UNSPEC;
+    dica.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host.c_str(), porta.c_str(), &dica, &lista) != 0) return -1;
+    int fd = -1;
+    for (addrinfo* a = lista; a && fd < 0; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) != 0) { close(fd); fd = -1; }
+    }
+    freeaddrinfo(lista);
+    return fd;
+}
+
+// Rodadas são curtas e de ida e volta: sem o atraso de Nagle.
+void semAtraso(int fd) {
+    int um = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &um, sizeof(um));
+}
+
+// Parte de cada vértice. Componentes fracamente conexos ficam inteiros (carteiras
+// costumam ser muitos projetos independentes); componente maior que V/partes vira
+// fatias consecutivas na ordem de entrada, em que as atividades de um projeto
+// costumam vir juntas (fatiar pela ordem topológica intercalaria os projetos e
+// cortaria muito mais arestas). Os itens vão do maior para o menor para a parte
+// menos cheia.
+template <class Idx, class Adj>
+Vetor<uint32_t> particionar(const Grafo<Idx, Adj>& g, size_t partes, pmr::memory_resource* mem) {
+    Idx n = g.qntV;
+    Vetor<Idx> raiz(n, Idx{}, mem);
+    for (Idx i = 0; i < n; i++) raiz[i] = i;
+    auto achar = [&](Idx x) {
+        while (raiz[x] != x) x = raiz[x] = raiz[raiz[x]];
+        return x;
+    };
+    for (Idx u = 0; u < n; u++)
+        g.suc.paraCada(u, [&](Idx v) {
+            Idx a = achar(u), b = achar(v);
+            if (a != b) raiz[max(a, b)] = min(a, b);
+        });
+
+    uint64_t alvo = max<uint64_t>(1, ((uint64_t)n + partes - 1) / partes);
+    Vetor<uint64_t> tamComp(n, 0, mem), vistos(n, 0, mem), itemComp(n, 0, mem);
+    for (Idx i = 0; i < n; i++) tamComp[achar(i)]++;
+    Vetor<uint32_t> parte(n, 0, mem);   // primeiro o item de cada vértice, depois a parte
+    Vetor<uint64_t> tamItem(mem);
+    for (Idx u = 0; u < n; u++) {
+        Idx r = achar(u);
+        if (vistos[r]++ % alvo == 0) {   // começo do componente ou de uma nova fatia
+            itemComp[r] = tamItem.size();
+            tamItem.push_back(0);
+        }
+        tamItem[itemComp[r]]++;
+        parte[u] = (uint32_t)itemComp[r];
+    }
+
+    Vetor<uint32_t> itens(tamItem.size(), 0, mem), parteItem(tamItem.size(), 0, mem);
+    for (size_t i = 0; i < itens.size(); i++) itens[i] = (uint32_t)i;
+    stable_sort(itens.begin(), itens.end(), [&](uint32_t a, uint32_t b) { return tamItem[a] > tamItem[b]; });
+    priority_queue<pair<uint64_t, uint32_t>, vector<pair<uint64_t, uint32_t>>, greater<>> carga;
+    for (uint32_t p = 0; p < partes; p++) carga.push({0, p});
+    for (uint32_t it : itens) {
+        auto [c, p] = carga.top();
+        carga.pop();
+        parteItem[it] = p;
+        carga.push({c + tamItem[it], p});
+    }
+    for (Idx u = 0; u < n; u++) parte[u] = parteItem[parte[u]];
+    return parte;
+}
+
+// Lado do trabalhador: guarda a parte e responde às rodadas até PARTE_FIM.
+// Índices locais seguem a ordem dos vértices no grafo; a ordem topológica local
+// sai das rodadas PARTE_ORDEM e é exigida antes da ida.
+template <class Tempo>
+bool servirParte(Canal& c) {
+    vector<Tempo> dur;
+    vector<uint64_t> predIni, predAlvo, predExtIni, predExtAlvo;   // externos: posição em 'entradas'
+    vector<uint64_t> sucIni, sucAlvo, sucExtIni, sucExtAlvo;       // externos: posição em 'saidas'
+    if (!c.tirarVetor(dur) || !c.tirarVetor(predIni) || !c.tirarVetor(predAlvo) || !c.tirarVetor(predExtIni) ||
+        !c.tirarVetor(predExtAlvo) || !c.tirarVetor(sucIni) || !c.tirarVetor(sucAlvo) || !c.tirarVetor(sucExtIni) ||
+        !c.tirarVetor(sucExtAlvo))
+        return false;
+    size_t n = dur.size();
+    vector<Tempo> ES(n), EF(n), LS(n), LF(n), entradas, saidas, resposta;
+
+    // Kahn: 'falta' conta predecessores internos e externos ainda fora da ordem;
+    // 'ordem' serve de fila. entradaSuc* lista os vértices locais de cada entrada.
+    size_t qntEntradas = 0;
+    for (uint64_t k : predExtAlvo) qntEntradas = max<size_t>(qntEntradas, k + 1);
+    vector<uint64_t> falta(n), ordem, entradaSucIni(qntEntradas + 1, 0), entradaSuc(predExtAlvo.size());
+    for (uint64_t k : predExtAlvo) entradaSucIni[k + 1]++;
+    for (size_t k = 0; k < qntEntradas; k++) entradaSucIni[k + 1] += entradaSucIni[k];
+    vector<uint64_t> cursor(entradaSucIni.begin(), entradaSucIni.end() - 1);
+    for (size_t u = 0; u < n; u++) {
+        falta[u] = (predIni[u + 1] - predIni[u]) + (predExtIni[u + 1] - predExtIni[u]);
+        for (uint64_t k = predExtIni[u]; k < predExtIni[u + 1]; k++) entradaSuc[cursor[predExtAlvo[k]]++] = u;
+        if (falta[u] == 0) ordem.push_back(u);
+    }
+    vector<uint8_t> prontas(qntEntradas, 0), avisos, feitos;
+    size_t cabeca = 0;
+
+    for (uint8_t cmd; c.receber() && c.tirar(cmd);) {
+        resposta.clear();
+        if (cmd == PARTE_ORDEM) {
+            if (!c.tirarVetor(avisos) || avisos.size() < qntEntradas) return false;
+            for (size_t k = 0; k < qntEntradas; k++) {
+                if (!avisos[k] || prontas[k]) continue;
+                prontas[k] = 1;
+                for (uint64_t j = entradaSucIni[k]; j < entradaSucIni[k + 1]; j++)
+                    if (--falta[entradaSuc[j]] == 0) ordem.push_back(entradaSuc[j]);
+            }
+            for (; cabeca < ordem.size(); cabeca++)
+                for (uint64_t k = sucIni[ordem[cabeca]]; k < sucIni[ordem[cabeca] + 1]; k++)
+                    if (--falta[sucAlvo[k]] == 0) ordem.push_back(sucAlvo[k]);
+            feitos.clear();
+            for (size_t u = 0; u < n; u++)
+                if (sucExtIni[u] != sucExtIni[u + 1]) feitos.push_back(falta[u] == 0);
+            c.porVetor(feitos);
+            c.por((uint64_t)(n - ordem.size()));
+        } else if (cmd == PARTE_FIM) {   // também encerra a parte após um ciclo
+            c.porVetor(ES);
+            c.porVetor(EF);
+            c.porVetor(LS);
+            c.porVetor(LF);
+            return c.enviar();
+        } else if (ordem.size() != n) {
+            return false;   // ida/volta antes da ordem completa
+        } else if (cmd == PARTE_IDA) {
+            if (!c.tirarVetor(entradas)) return false;
+            Tempo maxEF{};
+            for (uint64_t u : ordem) {
+                Tempo es{};
+                for (uint64_t k = predIni[u]; k < predIni[u + 1]; k++) es = max(es, EF[predAlvo[k]]);
+                for (uint64_t k = predExtIni[u]; k < predExtIni[u + 1]; k++) es = max(es, entradas[predExtAlvo[k]]);
+                ES[u] = es;
+                EF[u] = es + dur[u];
+                maxEF = max(maxEF, EF[u]);
+            }
+            for (size_t u = 0; u < n; u++) if (sucExtIni[u] != sucExtIni[u + 1]) resposta.push_back(EF[u]);
+            c.porVetor(resposta);
+            c.por(maxEF);
+        } else if (cmd == PARTE_VOLTA) {
+            Tempo duracao;
+            if (!c.tirar(duracao) || !c.tirarVetor(saidas)) return false;
+            for (size_t i = n; i-- > 0;) {
+                uint64_t u = ordem[i];
+                Tempo lf = TempoTraits<Tempo>::maximo();
+                bool temSucessor = false;
+                for (uint64_t k = sucIni[u]; k < sucIni[u + 1]; k++) { lf = min(lf, LS[sucAlvo[k]]); temSucessor = true; }
+                for (uint64_t k = sucExtIni[u]; k < sucExtIni[u + 1]; k++) { lf = min(lf, saidas[sucExtAlvo[k]]); temSucessor = true; }
+                LF[u] = temSucessor ? lf : duracao;
+                LS[u] = LF[u] - dur[u];
+            }
+            for (size_t u = 0; u < n; u++) if (predExtIni[u] != predExtIni[u + 1]) resposta.push_back(LS[u]);
+            c.porVetor(resposta);
+        } else {
+            return false;
+        }
+        if (!c.enviar()) return false;
+    }
+    return false;
+}
+
+// Processo trabalhador: conecta ao coordenador, atende uma parte e termina.
+int executarTrabalhador(const string& host, const string& porta) {
+    int fd = conectarTCP(host, porta);
+    if (fd < 0) {
+        cerr << "Erro: não foi possível conectar ao coordenador " << host << ":" << porta << ".\n";
+        return 1;
+    }
+    semAtraso(fd);
+    Canal c(fd);
+    string tipo;
+    bool ok = c.receber() && c.tirarVetor(tipo);
+    // os mesmos tipos de tempo que despacharTipos pode escolher neste binário
+#if defined(CPM_TEMPO_FIXO) || defined(CPM_TEMPO_REAL)
+    if (ok && tipo == nomeTipo<TempoFracionario>()) ok = servirParte<TempoFracionario>(c);
+#else
+    if (ok && tipo == nomeTipo<int32_t>()) ok = servirParte<int32_t>(c);
+    else if (ok && tipo == nomeTipo<int64_t>()) ok = servirParte<int64_t>(c);
+#endif
+    else ok = false;
+    if (!ok) cerr << "Erro: trabalhador perdeu o coordenador ou recebeu tipo desconhecido (" << tipo << ").\n";
+    return ok ? 0 : 1;
+}
+
+// Aceita 'quantidade' trabalhadores em 'porta'. Com 'locais', ouve só no loopback
+// numa porta livre e cria os trabalhadores com fork (PIDs em 'filhos').
+vector<Canal> aceitarTrabalhadores(size_t quantidade, uint16_t porta, bool locais, vector<pid_t>& filhos) {
+    vector<Canal> canais;
+    int fd = ouvirTCP(porta, locais, (int)min<size_t>(quantidade, 4096));
+    if (fd < 0) return canais;
+    if (locais) {
+        cout.flush();   // o filho herda o buffer: esvaziar antes para não duplicar saída
+        fflush(stdout);
+        for (size_t i = 0; i < quantidade; i++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                close(fd);
+                _exit(executarTrabalhador("127.0.0.1", to_string(porta)));
+            }
+            if (pid > 0) filhos.push_back(pid);
+        }
+        quantidade = filhos.size();
+    } else {
+        cerr << "Coordenador aguardando " << quantidade << " trabalhador(es) na porta " << porta << "...\n";
+    }
+    while (canais.size() < quantidade) {
+        int c = accept(fd, nullptr, nullptr);
+        if (c < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        semAtraso(c);
+        canais.emplace_back(c);
+    }
+    close(fd);
+    return canais;
+}
+
+// Coordenador: particiona, distribui as partes e conduz as rodadas. Retorna false
+// se houver ciclo ou falha de comunicação (erroRede indica qual).
+template <class Idx, class Adj, class Tempo>
+bool calcularPERTDistribuido(const Grafo<Idx, Adj>& g, Duracoes<Tempo> dur, vector<Canal>& trab,
+                             Vetor<Tempo>& ES, Vetor<Tempo>& EF, Vetor<Tempo>& LS, Vetor<Tempo>& LF,
+                             Tempo& duracaoProjeto, EstatDistribuido& est, bool& erroRede) {
+    pmr::memory_resource* mem = ES.get_allocator().resource();
+    Idx n = g.qntV;
+    size_t partes = trab.size();
+    erroRede = partes == 0;
+    if (erroRede) return false;
+    Vetor<uint32_t> parte = particionar(g, partes, mem);
+
+    // vértices de cada parte na ordem do grafo, e o índice local de cada um
+    vector<vector<Idx>> membros(partes);
+    Vetor<uint64_t> local(n, 0, mem);
+    for (Idx u = 0; u < n; u++) {
+        local[u] = membros[parte[u]].size();
+        membros[parte[u]].push_back(u);
+    }
+
+    // por parte: quem fornece EF (entradas) e LS (saídas) de fora, e de quem ela devolve
+    // EF (vértices com sucessor externo) e LS (com predecessor externo), na ordem local
+    vector<vector<Idx>> entradas(partes), saidas(partes), devolveEF(partes), devolveLS(partes);
+    const uint64_t NENHUM = UINT64_MAX;
+    Vetor<uint64_t> posExt(n, NENHUM, mem);
+    for (size_t p = 0; p < partes; p++) {
+        vector<uint64_t> predIni{0}, predAlvo, predExtIni{0}, predExtAlvo, sucIni{0}, sucAlvo, sucExtIni{0}, sucExtAlvo;
+        vector<Tempo> durLocal;
+        auto externo = [&](vector<Idx>& lista, Idx v) {
+            if (posExt[v] == NENHUM) { posExt[v] = lista.size(); lista.push_back(v); }
+            return posExt[v];
+        };
+        for (Idx u : membros[p]) {
+            durLocal.push_back(dur[u]);
+            g.pred.paraCada(u, [&](Idx v) {
+                if (parte[v] == p) predAlvo.push_back(local[v]);
+                else { predExtAlvo.push_back(externo(entradas[p], v)); est.arestasCorte++; }
+            });
+            predIni.push_back(predAlvo.size());
+            predExtIni.push_back(predExtAlvo.size());
+            if (predExtIni.back() != predExtIni[predExtIni.size() - 2]) devolveLS[p].push_back(u);
+        }
+        for (Idx v : entradas[p]) posExt[v] = NENHUM;
+        for (Idx u : membros[p]) {
+            g.suc.paraCada(u, [&](Idx v) {
+                if (parte[v] == p) sucAlvo.push_back(local[v]);
+                else sucExtAlvo.push_back(externo(saidas[p], v));
+            });
+            sucIni.push_back(sucAlvo.size());
+            sucExtIni.push_back(sucExtAlvo.size());
+            if (sucExtIni.back() != sucExtIni[sucExtIni.size() - 2]) devolveEF[p].push_back(u);
+        }
+        for (Idx v : saidas[p]) posExt[v] = NENHUM;
+
+        Canal& c = trab[p];
+        c.porVetor(string_view(nomeTipo<Tempo>()));
+        c.porVetor(durLocal);
+        c.porVetor(predIni); c.porVetor(predAlvo); c.porVetor(predExtIni); c.porVetor(predExtAlvo);
+        c.porVetor(sucIni); c.porVetor(sucAlvo); c.porVetor(sucExtIni); c.porVetor(sucExtAlvo);
+        if (!c.enviar()) return !(erroRede = true);
+    }
+    est.partes = partes;
+
+    // Uma rodada: envia a cada parte os valores de fora, recebe os de fronteira e
+    // atualiza 'valor'; retorna se algum mudou.
+    auto rodada = [&](ComandoParte cmd, const vector<vector<Idx>>& fora, const vector<vector<Idx>>& devolve,
+                      auto& valor, auto&& extra) {
+        vector<typename remove_reference_t<decltype(valor)>::value_type> lidos;
+        for (size_t p = 0; p < partes; p++) {
+            trab[p].por((uint8_t)cmd);
+            if (cmd == PARTE_VOLTA) trab[p].por(duracaoProjeto);
+            lidos.clear();
+            for (Idx v : fora[p]) lidos.push_back(valor[v]);
+            trab[p].porVetor(lidos);
+            if (!trab[p].enviar()) erroRede = true;
+        }
+        bool mudou = false;
+        for (size_t p = 0; p < partes && !erroRede; p++) {
+            if (!trab[p].receber() || !trab[p].tirarVetor(lidos) || lidos.size() != devolve[p].size()) {
+                erroRede = true;
+                break;
+            }
+            for (size_t k = 0; k < lidos.size(); k++)
+                if (valor[devolve[p][k]] != lidos[k]) { valor[devolve[p][k]] = lidos[k]; mudou = true; }
+            extra(trab[p]);
+        }
+        return mudou && !erroRede;
+    };
+
+    // -------- ordem (Kahn distribuído) --------
+    // 'feito' marca vértices com sucessor externo que já saíram da ordem da sua parte
+    Vetor<uint8_t> feito(n, 0, mem);
+    uint64_t pendentes = 0, resto = 0;
+    do {
+        est.rodadasOrdem++;
+        pendentes = 0;
+    } while (rodada(PARTE_ORDEM, entradas, devolveEF, feito, [&](Canal& c) {
+        if (!c.tirar(resto)) erroRede = true;
+        pendentes += resto;
+    }));
+    if (erroRede) return false;
+    if (pendentes) {   // vértices pendentes: ciclo; dispensa os trabalhadores
+        for (size_t p = 0; p < partes; p++) {
+            trab[p].por((uint8_t)PARTE_FIM);
+            if (!trab[p].enviar() || !trab[p].receber()) erroRede = true;
+        }
+        return false;
+    }
+
+    // -------- ida (ES/EF) --------
+    EF.assign(n, Tempo{});
+    Tempo maxEF{};
+    do {
+        est.rodadasIda++;
+        duracaoProjeto = Tempo{};
+    } while (rodada(PARTE_IDA, entradas, devolveEF, EF, [&](Canal& c) {
+        if (!c.tirar(maxEF)) erroRede = true;
+        duracaoProjeto = max(duracaoProjeto, maxEF);
+    }));
+    if (erroRede) return false;
+
+    // -------- volta (LS/LF) --------
+    LS.assign(n, duracaoProjeto);
+    do est.rodadasVolta++;
+    while (rodada(PARTE_VOLTA, saidas, devolveLS, LS, [](Canal&) {}));
+    if (erroRede) return false;
+
+    // -------- resultado de cada parte --------
+    ES.resize(n);
+    LF.resize(n);
+    vector<Tempo> es, ef, ls, lf;
+    for (size_t p = 0; p < partes; p++) {
+        trab[p].por((uint8_t)PARTE_FIM);
+        if (!trab[p].enviar() || !trab[p].receber() || !trab[p].tirarVetor(es) || !trab[p].tirarVetor(ef) ||
+            !trab[p].tirarVetor(ls) || !trab[p].tirarVetor(lf) || es.size() != membros[p].size())
+            return !(erroRede = true);
+        for (size_t k = 0; k < membros[p].size(); k++) {
+            Idx u = membros[p][k];
+            ES[u] = es[k];
+            EF[u] = ef[k];
+            LS[u] = ls[k];
+            LF[u] = lf[k];
+        }
+        est.bytes += trab[p].bytes();
+    }
+    return true;
+}
+
+// ---------------- encontrar um caminho crítico ----------------
+// Aresta justa u -> v: v começa quando u termina (ES[v] == EF[u]). Com progresso, um
+// sucessor já iniciado tem ES real antes de EF[u] e ainda espera u para o que lhe resta.
+template <class Tempo>
+inline bool justa(Tempo efU, Tempo esV) { return esV <= efU || TempoTraits<Tempo>::igual(esV, efU); }
+
+// Folga total zero, com a igualdade de TempoTraits (tolerante em ponto flutuante).
+template <class Tempo>
+inline bool semFolga(Tempo ls, Tempo es) { return TempoTraits<Tempo>::igual(ls, es); }
+
+// Escreve o caminho em 'caminho' (ao menos g.qntV posições) e retorna o tamanho;
+// 0 se não houver atividade crítica.
+template <class Idx, class Adj, class Tempo>
+size_t encontrarCaminhoCritico(const Grafo<Idx, Adj>& g, Faixa<const Tempo> ES, Faixa<const Tempo> EF,
+                               Faixa<const Tempo> LS, Faixa<Idx> caminho) {
+    const Idx NENHUM = Grafo<Idx>::NENHUM;
+    Idx qntV = g.qntV;
+
+    // começa pela primeira atividade crítica sem predecessores; na falta, pela primeira crítica
+    Idx inicio = NENHUM;
+    for (Idx i = 0; i < qntV && inicio == NENHUM; i++)
+        if (g.pred.grau(i) == 0 && semFolga(LS[i], ES[i])) inicio = i;
+    for (Idx i = 0; i < qntV && inicio == NENHUM; i++)
+        if (semFolga(LS[i], ES[i])) inicio = i;
+
+    size_t tam = 0;
+    for (Idx cur = inicio; cur != NENHUM;) {
+        caminho[tam++] = cur;
+        Idx proximo = NENHUM;
+        g.suc.paraCada(cur, [&](Idx v) {   // o primeiro sucessor crítico justo
+            if (proximo == NENHUM && semFolga(LS[v], ES[v]) && justa(EF[cur], ES[v])) proximo = v;
+        });
+        cur = proximo;
+    }
+    return tam;
+}
+
+template <class Idx, class Adj, class Tempo>
+Vetor<Idx> encontrarCaminhoCritico(const Grafo<Idx, Adj>& g, const Vetor<Tempo>& ES, const Vetor<Tempo>& EF, const Vetor<Tempo>& LS,
+                                   pmr::memory_resource* mem = pmr::get_default_resource()) {
+    Vetor<Idx> caminho(g.qntV, Idx{}, mem);
+    caminho.resize(encontrarCaminhoCritico(g, Faixa<const Tempo>(ES), Faixa<const Tempo>(EF),
+                                           Faixa<const Tempo>(LS), Faixa<Idx>(caminho)));
+    return caminho;
+}
+
+// ---------------- escrita bufferizada ----------------
+// Buffer fixo descarregado com fwrite e números convertidos com to_chars:
+// nenhuma alocação por item escrito, seja JSON, DOT ou GraphML.
+enum class Escape { JSON, XML, DOT, CSV };
+
+struct Escapado {
+    string_view s;
+    Escape modo;
+};
+inline Escapado json(string_view s) { return {s, Escape::JSON}; }  // com aspas
+inline Escapado xml(string_view s) { return {s, Escape::XML}; }    // sem aspas
+inline Escapado dot(string_view s) { return {s, Escape::DOT}; }    // com aspas
+inline Escapado csv(string_view s) { return {s, Escape::CSV}; }    // com aspas
+
+class EscritorBuffer {
+public:
+    explicit EscritorBuffer(const string& caminhoArq) : arq(fopen(caminhoArq.c_str(), "wb")) {}
+    // Atômico: grava em caminhoArq.tmp e só renomeia sobre caminhoArq num fechar() sem
+    // erro; quem lê o arquivo (grafo.html, outro processo) nunca vê uma versão pela metade.
+    struct Atomico {};
+    EscritorBuffer(const string& caminhoArq, Atomico)
+        : arq(fopen((caminhoArq + ".tmp").c_str(), "wb")), destino(caminhoArq) {}
+    // Fluxo já aberto (ex.: stdout): só é descarregado, nunca fechado.
+    explicit EscritorBuffer(FILE* fluxo) : arq(fluxo), proprio(false) {}
+    ~EscritorBuffer() { fechar(); }
+    EscritorBuffer(const EscritorBuffer&) = delete;
+    EscritorBuffer& operator=(const EscritorBuffer&) = delete;
+
+    bool aberto() const { return arq != nullptr; }
+
+    // Descarrega e fecha; false se alguma escrita falhou.
+    bool fechar() {
+        if (!arq) return !erro;
+        descarregar();
+        if (proprio ? fclose(arq) != 0 : fflush(arq) != 0) erro = true;
+        arq = nullptr;
+        if (!destino.empty()) {
+            string temp = destino + ".tmp";
+            if (erro || rename(temp.c_str(), destino.c_str()) != 0) {
+                erro = true;
+                remove(temp.c_str());
+            }
+        }
+        return !erro;
+    }
+
+    EscritorBuffer& operator<<(char c) {
+        if (n == sizeof(buf)) descarregar();
+        buf[n++] = c;
+        return *this;
+    }
+    EscritorBuffer& operator<<(string_view s) {
+        if (s.size() > sizeof(buf) - n) {
+            descarregar();
+            if (s.size() > sizeof(buf)) {
+                if (arq && fwrite(s.data(), 1, s.size(), arq) != s.size()) erro = true;
+                return *this;
+            }
+        }
+        memcpy(buf + n, s.data(), s.size());
+        n += s.size();
+        return *this;
+    }
+    EscritorBuffer& operator<<(const char* s) { return *this << string_view(s); }
+    EscritorBuffer& operator<<(const string& s) { return *this << string_view(s); }
+
+    template <class T, class = enable_if_t<is_integral_v<T> && !is_same_v<T, char> && !is_same_v<T, bool>>>
+    EscritorBuffer& operator<<(T v) {
+        if (sizeof(buf) - n < 24) descarregar();
+        n = (size_t)(to_chars(buf + n, buf + sizeof(buf), v).ptr - buf);
+        return *this;
+    }
+
+    EscritorBuffer& operator<<(double v) {
+        if (sizeof(buf) - n < 32) descarregar();
+        n = (size_t)(to_chars(buf + n, buf + sizeof(buf), v).ptr - buf);
+        return *this;
+    }
+    EscritorBuffer& operator<<(TempoFixo v) {
+        if (sizeof(buf) - n < 32) descarregar();
+        n += formatarTempo(v, buf + n, sizeof(buf) - n).size();
+        return *this;
+    }
+
+    EscritorBuffer& operator<<(const Escapado& e) {
+        if (e.modo != Escape::XML) *this << '"';
+        for (char c : e.s) {
+            unsigned char u = (unsigned char)c;
+            switch (e.modo) {
+                case Escape::JSON:
+                    if (c == '"' || c == '\\') *this << '\\' << c;
+                    else if (c == '\n') *this << "\\n";
+                    else if (c == '\t') *this << "\\t";
+                    else if (u < 0x20) {
+                        const char* hex = "0123456789abcdef";
+                        *this << "\\u00" << hex[u >> 4] << hex[u & 15];
+                    } else *this << c;
+                    break;
+                case Escape::XML:
+                    if (c == '&') *this << "&amp;";
+                    else if (c == '<') *this << "&lt;";
+                    else if (c == '>') *this << "&gt;";
+                    else if (c == '"') *this << "&quot;";
+                    else if (u < 0x20 && c != '\n' && c != '\t') *this << ' ';  // inválido em XML 1.0
+                    else *this << c;
+                    break;
+                case Escape::DOT:
+                    if (c == '"' || c == '\\') *this << '\\' << c;
+                    else if (c == '\n') *this << "\\n";
+                    else *this << c;
+                    break;
+                case Escape::CSV:
+                    if (c == '"') *this << '"';
+                    *this << c;
+                    break;
+            }
+        }
+        if (e.modo != Escape::XML) *this << '"';
+        return *this;
+    }
+
+private:
+    FILE* arq;
+    string destino;   // modo atômico: nome final do arquivo
+    bool proprio = true;
+    char buf[1 << 16];
+    size_t n = 0;
+    bool erro = false;
+
+    void descarregar() {
+        if (arq && n && fwrite(buf, 1, n, arq) != n) erro = true;
+        n = 0;
+    }
+};
+
+// ---------------- CPM em tempo de compilação ----------------
+// cpm_constexpr.hpp repete, sobre std::array, as regras de calcularPERT e do caminho
+// crítico acima para quem embute um modelo fixo. O exemplo de referência (a rede de
+// seis atividades da saída esperada) é conferido na compilação: se as regras do
+// cabeçalho se afastarem das daqui, o build quebra.
+constexpr ModeloFixo<int, 6, 6> exemploFixo{
+    {10, 4, 7, 5, 5, 2},
+    {{{0, 1}, {0, 2}, {2, 3}, {1, 4}, {3, 4}, {2, 5}}}};
+constexpr CronogramaFixo<int, 6> cronogramaExemploFixo = calcularPERTFixo(exemploFixo);
+static_assert(aciclico(exemploFixo) && cronogramaExemploFixo.ok && cronogramaExemploFixo.duracao == 27,
+              "duração do exemplo de referência");
+static_assert(cronogramaExemploFixo.folga(1) == 8 && cronogramaExemploFixo.folga(5) == 8 &&
+              cronogramaExemploFixo.ES[3] == 17 && cronogramaExemploFixo.LS[1] == 18,
+              "folgas e datas do exemplo de referência");
+static_assert(cronogramaExemploFixo.tamCaminho == 4 && cronogramaExemploFixo.caminho[0] == 0 &&
+              cronogramaExemploFixo.caminho[1] == 2 && cronogramaExemploFixo.caminho[2] == 3 &&
+              cronogramaExemploFixo.caminho[3] == 4,
+              "caminho crítico 1 -> 3 -> 4 -> 5");
+static_assert(cronogramaExemploFixo.deslocado(5).ES[2] == 15 && cronogramaExemploFixo.deslocado(5).duracao == 27,
+              "deslocamento do início");
+constexpr ModeloFixo<int, 2, 2> cicloFixo{{1, 1}, {{{0, 1}, {1, 0}}}};
+static_assert(!aciclico(cicloFixo) && !calcularPERTFixo(cicloFixo).ok, "ciclo barrado");
+
+// ---------------- subgrafo crítico ----------------
+// Todos os nós de folga zero e as arestas justas (justa(EF[u], ES[v])) entre eles, em
+// O(V+E) sobre as listas de sucessores. Todo caminho crítico está contido nele.
+template <class Idx>
+struct SubgrafoCritico {
+    Vetor<Idx> nos;
+    Vetor<pair<Idx, Idx>> arestas;
+    uint64_t inicios = 0, fins = 0;   // nós sem aresta justa de entrada / de saída
+    long long caminhos = 0;           // caminhos críticos distintos (satura em LLONG_MAX)
+
+    explicit SubgrafoCritico(pmr::memory_resource* mem = pmr::get_default_resource()) : nos(mem), arestas(mem) {}
+};
+
+template <class Idx, class Adj, class Tempo>
+SubgrafoCritico<Idx> extrairSubgrafoCritico(const Grafo<Idx, Adj>& g,
+                                            const Vetor<Tempo>& ES, const Vetor<Tempo>& EF, const Vetor<Tempo>& LS,
+                                            pmr::memory_resource* mem = pmr::get_default_resource()) {
+    Idx qntV = g.qntV;
+    const Adj& suc = g.suc;
+    SubgrafoCritico<Idx> sub(mem);
+    vector<Desl<Idx>> grauEnt(qntV, 0), grauSai(qntV, 0);
+    for (Idx u = 0; u < qntV; u++) {
+        if (!semFolga(LS[u], ES[u])) continue;
+        sub.nos.push_back(u);
+        suc.paraCada(u, [&](Idx v) {
+            if (semFolga(LS[v], ES[v]) && justa(EF[u], ES[v])) {
+                sub.arestas.emplace_back(u, v);
+                grauSai[u]++;
+                grauEnt[v]++;
+            }
+        });
+    }
+
+    // contagem de caminhos em ordem topológica (Kahn restrito ao subgrafo)
+    vector<long long> cont(qntV, 0);
+    vector<Idx> fila;
+    fila.reserve(sub.nos.size());
+    for (Idx u : sub.nos) {
+        if (grauEnt[u] == 0) { sub.inicios++; cont[u] = 1; fila.push_back(u); }
+        if (grauSai[u] == 0) sub.fins++;
+    }
+    for (size_t h = 0; h < fila.size(); h++) {
+        Idx u = fila[h];
+        if (grauSai[u] == 0) {
+            sub.caminhos = (sub.caminhos > LLONG_MAX - cont[u]) ? LLONG_MAX : sub.caminhos + cont[u];
+            continue;
+        }
+        suc.paraCada(u, [&](Idx v) {
+            if (!semFolga(LS[v], ES[v]) || !justa(EF[u], ES[v])) return;
+            cont[v] = (cont[v] > LLONG_MAX - cont[u]) ? LLONG_MAX : cont[v] + cont[u];
+            if (--grauEnt[v] == 0) fila.push_back(v);
+        });
+    }
+    return sub;
+}
+
+// ---------------- gerar JSON para visualização externa ----------------
+template <class Idx, class Adj, class Tempo>
+void gerarJSON_vis(const Grafo<Idx, Adj>& g,
+                   const Rotulos& rotulos,
+                   Duracoes<Tempo> dur,
+                   const Vetor<Idx>& caminhoCrit,
+                   const SubgrafoCritico<Idx>& sub,
+                   const Vetor<Tempo>& ES, const Vetor<Tempo>& EF,
+                   const Vetor<Tempo>& LS, const Vetor<Tempo>& LF,
+                   Tempo duracaoProjeto, long long versao) {
+    Idx qntV = g.qntV;
+
+    EscritorBuffer f("grafo.json", EscritorBuffer::Atomico{});
+    if (!f.aberto()) {
+        cerr << "Aviso: não foi possível criar grafo.json.\n";
+        return;
+    }
+
+    f << "{\n";
+    f << "  \"version\": " << versao << ",\n";
+    f << "  \"nodes\": [\n";
+    for (Idx i = 0; i < qntV; i++) {
+        f << "    {\"id\": " << json(rotulos[i]) << ", \"duration\": " << dur[i]
+          << ", \"ES\": " << ES[i] << ", \"EF\": " << EF[i]
+          << ", \"LS\": " << LS[i] << ", \"LF\": " << LF[i] << "}";
+        if (i != qntV - 1) f << ",";
+        f << "\n";
+    }
+    f << "  ],\n";
+
+    f << "  \"edges\": [\n";
+    bool first = true;
+    auto writeComma = [&](bool &first) { if (!first) f << ",\n"; else first = false; };
+
+    for (Idx i = 0; i < qntV; i++) {
+        g.suc.paraCada(i, [&](Idx v) {
+            writeComma(first);
+            f << "    {\"from\": " << json(rotulos[i]) << ", \"to\": " << json(rotulos[v]) << "}";
+        });
+    }
+    f << "\n  ],\n";
+
+    f << "  \"critical_path\": [\n";
+    for (size_t i = 0; i < caminhoCrit.size(); i++) {
+        f << "    " << json(rotulos[caminhoCrit[i]]);
+        if (i != caminhoCrit.size() - 1) f << ",";
+        f << "\n";
+    }
+    f << "  ],\n";
+
+    // subgrafo crítico por índice na lista "nodes", para não repetir rótulos
+    f << "  \"critical_subgraph\": {\n";
+    f << "    \"nodes\": [";
+    for (size_t i = 0; i < sub.nos.size(); i++) f << (i ? ", " : "") << sub.nos[i];
+    f << "],\n";
+    f << "    \"edges\": [";
+    for (size_t i = 0; i < sub.arestas.size(); i++)
+        f << (i ? ", " : "") << "[" << sub.arestas[i].first << ", " << sub.arestas[i].second << "]";
+    f << "],\n";
+    f << "    \"stats\": {\"nodes\": " << sub.nos.size() << ", \"edges\": " << sub.arestas.size()
+      << ", \"sources\": " << sub.inicios << ", \"sinks\": " << sub.fins
+      << ", \"paths\": " << sub.caminhos << ", \"duration\": " << duracaoProjeto << "}\n";
+    f << "  }\n";
+
+    f << "}\n";
+    if (!f.fechar()) cerr << "Aviso: falha ao escrever grafo.json.\n";
+}
+
+// ---------------- exportação DOT / GraphML ----------------
+// Escritas em fluxo direto das listas de sucessores, com os tempos do cronograma
+// e a marca de crítico (folga zero; aresta justa entre dois nós críticos).
+template <class Tempo>
+inline bool arestaCritica(size_t u, size_t v, const Vetor<Tempo>& ES, const Vetor<Tempo>& EF, const Vetor<Tempo>& LS) {
+    return semFolga(LS[u], ES[u]) && semFolga(LS[v], ES[v]) && justa(EF[u], ES[v]);
+}
+
+template <class Idx, class Adj, class Tempo>
+bool gerarDOT(const string& caminhoArq, const Grafo<Idx, Adj>& g,
+              const Rotulos& rotulos, Duracoes<Tempo> dur,
+              const Vetor<Tempo>& ES, const Vetor<Tempo>& EF,
+              const Vetor<Tempo>& LS, const Vetor<Tempo>& LF) {
+    Idx qntV = g.qntV;
+    const Adj& suc = g.suc;
+    EscritorBuffer f(caminhoArq);
+    if (!f.aberto()) {
+        cerr << "Aviso: não foi possível criar " << caminhoArq << ".\n";
+        return false;
+    }
+    f << "digraph PERT {\n";
+    f << "  rankdir=LR;\n";
+    f << "  node [shape=box];\n";
+    for (Idx i = 0; i < qntV; i++) {
+        bool crit = semFolga(LS[i], ES[i]);
+        f << "  n" << i << " [label=" << dot(rotulos[i]) << ", dur=" << dur[i]
+          << ", es=" << ES[i] << ", ef=" << EF[i] << ", ls=" << LS[i] << ", lf=" << LF[i]
+          << ", folga=" << LS[i] - ES[i] << ", critical=" << (crit ? "true" : "false");
+        if (crit) f << ", color=red, penwidth=2";
+        f << "];\n";
+    }
+    for (Idx u = 0; u < qntV; u++) {
+        suc.paraCada(u, [&](Idx v) {
+            f << "  n" << u << " -> n" << v;
+            if (arestaCritica(u, v, ES, EF, LS)) f << " [critical=true, color=red, penwidth=2]";
+            f << ";\n";
+        });
+    }
+    f << "}\n";
+    if (!f.fechar()) {
+        cerr << "Aviso: falha ao escrever " << caminhoArq << ".\n";
+        return false;
+    }
+    return true;
+}
+
+template <class Idx, class Adj, class Tempo>
+bool gerarGraphML(const string& caminhoArq, const Grafo<Idx, Adj>& g,
+                  const Rotulos& rotulos, Duracoes<Tempo> dur,
+                  const Vetor<Tempo>& ES, const Vetor<Tempo>& EF,
+                  const Vetor<Tempo>& LS, const Vetor<Tempo>& LF) {
+    Idx qntV = g.qntV;
+    const Adj& suc = g.suc;
+    EscritorBuffer f(caminhoArq);
+    if (!f.aberto()) {
+        cerr << "Aviso: não foi possível criar " << caminhoArq << ".\n";
+        return false;
+    }
+    f << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    f << "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n";
+    f << "  <key id=\"label\" for=\"node\" attr.name=\"label\" attr.type=\"string\"/>\n";
+    const char* tipoTempo = !is_integral_v<Tempo> ? "double" : sizeof(Tempo) <= 4 ? "int" : "long";
+    const char* camposTempo[] = {"duration", "ES", "EF", "LS", "LF", "float"};
+    for (const char* c : camposTempo)
+        f << "  <key id=\"" << c << "\" for=\"node\" attr.name=\"" << c << "\" attr.type=\"" << tipoTempo << "\"/>\n";
+    f << "  <key id=\"critical\" for=\"node\" attr.name=\"critical\" attr.type=\"boolean\"/>\n";
+    f << "  <key id=\"ecritical\" for=\"edge\" attr.name=\"critical\" attr.type=\"boolean\"/>\n";
+    f << "  <graph id=\"PERT\" edgedefault=\"directed\">\n";
+    for (Idx i = 0; i < qntV; i++) {
+        f << "    <node id=\"n" << i << "\">"
+          << "<data key=\"label\">" << xml(rotulos[i]) << "</data>"
+          << "<data key=\"duration\">" << dur[i] << "</data>"
+          << "<data key=\"ES\">" << ES[i] << "</data>"
+          << "<data key=\"EF\">" << EF[i] << "</data>"
+          << "<data key=\"LS\">" << LS[i] << "</data>"
+          << "<data key=\"LF\">" << LF[i] << "</data>"
+          << "<data key=\"float\">" << LS[i] - ES[i] << "</data>"
+          << "<data key=\"critical\">" << (semFolga(LS[i], ES[i]) ? "true" : "false") << "</data>"
+          << "</node>\n";
+    }
+    for (Idx u = 0; u < qntV; u++) {
+        suc.paraCada(u, [&](Idx v) {
+            f << "    <edge source=\"n" << u << "\" target=\"n" << v << "\">"
+              << "<data key=\"ecritical\">" << (arestaCritica(u, v, ES, EF, LS) ? "true" : "false") << "</data>"
+              << "</edge>\n";
+        });
+    }
+    f << "  </graph>\n";
+    f << "</graphml>\n";
+    if (!f.fechar()) {
+        cerr << "Aviso: falha ao escrever " << caminhoArq << ".\n";
+        return false;
+    }
+    return true;
+}
+
+// ---------------- leitor JSON incremental (pull) ----------------
+// Entrega um token por vez lendo o arquivo em blocos fixos, sem montar a
+// árvore: a memória fica limitada ao maior token, não ao tamanho do arquivo.
+class LeitorJSON {
+public:
+    enum Tipo { FIM, INICIO_OBJ, FIM_OBJ, INICIO_ARR, FIM_ARR, CHAVE, TEXTO, NUMERO, LITERAL, ERRO };
+
+    explicit LeitorJSON(istream& in) : in(in) {}
+
+    Tipo proximo() {
+        int c = pularEspacos();
+        while (c == ',' || c == ':') { pos++; c = pularEspacos(); }
+        if (c == EOF) return ultimo = FIM;
+        pos++;
+        switch (c) {
+            case '{': return ultimo = INICIO_OBJ;
+            case '}': return ultimo = FIM_OBJ;
+            case '[': return ultimo = INICIO_ARR;
+            case ']': return ultimo = FIM_ARR;
+            case '"': {
+                if (!lerString()) return ultimo = ERRO;
+                // string seguida de ':' é chave de objeto
+                if (pularEspacos() == ':') { pos++; return ultimo = CHAVE; }
+                return ultimo = TEXTO;
+            }
+        }
+        tok.assign(1, (char)c);
+        while ((c = espiar()) != EOF && c != ',' && c != '}' && c != ']' && c != ':' && !isspace(c)) {
+            tok.push_back((char)c);
+            pos++;
+        }
+        if (tok[0] == '-' || isdigit((unsigned char)tok[0])) return ultimo = NUMERO;
+        if (tok == "true" || tok == "false" || tok == "null") return ultimo = LITERAL;
+        return ultimo = ERRO;
+    }
+
+    // Se o último token abriu um objeto/array, consome até o fechamento correspondente.
+    void pular() {
+        if (ultimo != INICIO_OBJ && ultimo != INICIO_ARR) return;
+        int prof = 1;
+        while (prof > 0) {
+            Tipo t = proximo();
+            if (t == INICIO_OBJ || t == INICIO_ARR) prof++;
+            else if (t == FIM_OBJ || t == FIM_ARR) prof--;
+            else if (t == FIM || t == ERRO) return;
+        }
+    }
+
+    const string& texto() const { return tok; }
+    long long inteiro() const { return strtoll(tok.c_str(), nullptr, 10); }
+    double real() const { return strtod(tok.c_str(), nullptr); }
+
+private:
+    istream& in;
+    char buf[1 << 16];
+    size_t pos = 0, lim = 0;
+    string tok;
+    Tipo ultimo = FIM;
+
+    int espiar() {
+        if (pos == lim) {
+            in.read(buf, sizeof(buf));
+            lim = (size_t)in.gcount();
+            pos = 0;
+            if (lim == 0) return EOF;
+        }
+        return (unsigned char)buf[pos];
+    }
+    int pularEspacos() {
+        int c;
+        while ((c = espiar()) != EOF && isspace(c)) pos++;
+        return c;
+    }
+    void utf8(unsigned cp) {
+        if (cp < 0x80) tok.push_back((char)cp);
+        else if (cp < 0x800) { tok.push_back((char)(0xC0 | (cp >> 6))); tok.push_back((char)(0x80 | (cp & 0x3F))); }
+        else if (cp < 0x10000) {
+            tok.push_back((char)(0xE0 | (cp >> 12)));
+            tok.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            tok.push_back((char)(0x80 | (cp & 0x3F)));
+        } else {
+            tok.push_back((char)(0xF0 | (cp >> 18)));
+            tok.push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+            tok.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            tok.push_back((char)(0x80 | (cp & 0x3F)));
+        }
+    }
+    bool lerHex4(unsigned& cp) {
+        cp = 0;
+        for (int k = 0; k < 4; k++) {
+            int h = espiar();
+            if (h == EOF || !isxdigit(h)) return false;
+            pos++;
+            cp = cp * 16 + (unsigned)(isdigit(h) ? h - '0' : (tolower(h) - 'a' + 10));
+        }
+        return true;
+    }
+    bool lerString() {
+        tok.clear();
+        int c;
+        while ((c = espiar()) != EOF) {
+            pos++;
+            if (c == '"') return true;
+            if (c != '\\') { tok.push_back((char)c); continue; }
+            c = espiar();
+            if (c == EOF) return false;
+            pos++;
+            switch (c) {
+                case 'n': tok.push_back('\n'); break;
+                case 't': tok.push_back('\t'); break;
+                case 'r': tok.push_back('\r'); break;
+                case 'b': tok.push_back('\b'); break;
+                case 'f': tok.push_back('\f'); break;
+                case 'u': {
+                    unsigned cp;
+                    if (!lerHex4(cp)) return false;
+                    if (cp >= 0xD800 && cp < 0xDC00 && espiar() == '\\') {
+                        pos++;
+                        unsigned lo;
+                        if (espiar() != 'u') return false;
+                        pos++;
+                        if (!lerHex4(lo)) return false;
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    }
+                    utf8(cp);
+                    break;
+                }
+                default: tok.push_back((char)c);
+            }
+        }
+        return false;
+    }
+};
+
+// ---------------- cronograma (versão gravada em grafo.json) ----------------
+// Instantâneo independente da instanciação que o gerou: tempos em double (exato
+// para inteiros até 2^53 e para o ponto fixo) e índices de 64 bits. Campo ausente no
+// arquivo (ex.: grafo.json de versões antigas) fica como SEM_VALOR (NaN), o que
+// faz o delta tratá-lo como alterado.
+const double SEM_VALOR = numeric_limits<double>::quiet_NaN();
+
+struct Cronograma {
+    static constexpr uint64_t NENHUM = UINT64_MAX;   // rótulo sem par na outra versão
+
+    long long versao = 0;
+    Rotulos rotulos;
+    Vetor<double> dur, ES, EF, LS, LF;
+    vector<pair<uint64_t, uint64_t>> arestas;
+    Vetor<uint64_t> caminho;
+    SubgrafoCritico<uint64_t> crit;
+    double duracao = SEM_VALOR;
+};
+
+// arestas (u, v) em conjuntos de hash, sem limitar u e v a 32 bits
+struct HashAresta {
+    size_t operator()(const pair<uint64_t, uint64_t>& a) const {
+        return hash<uint64_t>()(a.first * 0x9E3779B97F4A7C15ull ^ a.second);
+    }
+};
+
+template <class Idx, class Adj, class Tempo>
+Cronograma montarCronograma(const Grafo<Idx, Adj>& g, const Rotulos& rotulos, Duracoes<Tempo> dur,
+                            const Vetor<Idx>& caminhoCrit, const SubgrafoCritico<Idx>& sub,
+                            const Vetor<Tempo>& ES, const Vetor<Tempo>& EF,
+                            const Vetor<Tempo>& LS, const Vetor<Tempo>& LF, Tempo duracaoProjeto) {
+    auto real = [](const auto& v) {
+        Vetor<double> r(v.size());
+        for (size_t i = 0; i < v.size(); i++) r[i] = TempoTraits<Tempo>::real(v[i]);
+        return r;
+    };
+    Cronograma c;
+    // sempre empacotado: a comparação e o delta guardam views dos rótulos
+    c.rotulos.reserve(rotulos.size());
+    for (size_t i = 0; i < rotulos.size(); i++) c.rotulos.push_back(rotulos[i]);
+    c.dur = real(dur);
+    c.ES = real(ES); c.EF = real(EF); c.LS = real(LS); c.LF = real(LF);
+    c.caminho.assign(caminhoCrit.begin(), caminhoCrit.end());
+    c.crit.nos.assign(sub.nos.begin(), sub.nos.end());
+    c.crit.arestas.assign(sub.arestas.begin(), sub.arestas.end());
+    c.crit.inicios = sub.inicios;
+    c.crit.fins = sub.fins;
+    c.crit.caminhos = sub.caminhos;
+    c.duracao = TempoTraits<Tempo>::real(duracaoProjeto);
+    c.arestas.reserve(g.suc.arestas());
+    for (Idx i = 0; i < g.qntV; i++)
+        g.suc.paraCada(i, [&](Idx v) { c.arestas.emplace_back((uint64_t)i, (uint64_t)v); });
+    return c;
+}
+
+bool lerCronogramaJSON(const string& caminhoArq, Cronograma& c) {
+    ifstream f(caminhoArq, ios::binary);
+    if (!f.is_open()) return false;
+    LeitorJSON js(f);
+    if (js.proximo() != LeitorJSON::INICIO_OBJ) return false;
+
+    c = Cronograma();
+    vector<pair<string, string>> arestasRot;
+    vector<string> caminhoRot;
+    LeitorJSON::Tipo t;
+    while ((t = js.proximo()) == LeitorJSON::CHAVE) {
+        string chave = js.texto();
+        t = js.proximo();
+        if (chave == "version" && t == LeitorJSON::NUMERO) {
+            c.versao = js.inteiro();
+        } else if (chave == "nodes" && t == LeitorJSON::INICIO_ARR) {
+            while ((t = js.proximo()) == LeitorJSON::INICIO_OBJ) {
+                string id;
+                double d = SEM_VALOR, es = SEM_VALOR, ef = SEM_VALOR, ls = SEM_VALOR, lf = SEM_VALOR;
+                while ((t = js.proximo()) == LeitorJSON::CHAVE) {
+                    string campo = js.texto();
+                    t = js.proximo();
+                    if (campo == "id" && (t == LeitorJSON::TEXTO || t == LeitorJSON::NUMERO)) id = js.texto();
+                    else if (t != LeitorJSON::NUMERO) js.pular();
+                    else if (campo == "duration") d = js.real();
+                    else if (campo == "ES") es = js.real();
+                    else if (campo == "EF") ef = js.real();
+                    else if (campo == "LS") ls = js.real();
+                    else if (campo == "LF") lf = js.real();
+                }
+                if (t != LeitorJSON::FIM_OBJ) return false;
+                c.rotulos.push_back(id);
+                c.dur.push_back(d);
+                c.ES.push_back(es); c.EF.push_back(ef);
+                c.LS.push_back(ls); c.LF.push_back(lf);
+            }
+            if (t != LeitorJSON::FIM_ARR) return false;
+        } else if (chave == "edges" && t == LeitorJSON::INICIO_ARR) {
+            while ((t = js.proximo()) == LeitorJSON::INICIO_OBJ) {
+                string de, para;
+                while ((t = js.proximo()) == LeitorJSON::CHAVE) {
+                    string campo = js.texto();
+                    t = js.proximo();
+                    if (campo == "from") de = js.texto();
+                    else if (campo == "to") para = js.texto();
+                    else js.pular();
+                }
+                if (t != LeitorJSON::FIM_OBJ) return false;
+                arestasRot.emplace_back(de, para);
+            }
+            if (t != LeitorJSON::FIM_ARR) return false;
+        } else if (chave == "critical_path" && t == LeitorJSON::INICIO_ARR) {
+            while ((t = js.proximo()) == LeitorJSON::TEXTO || t == LeitorJSON::NUMERO)
+                caminhoRot.push_back(js.texto());
+            if (t != LeitorJSON::FIM_ARR) return false;
+        } else if (chave == "critical_subgraph" && t == LeitorJSON::INICIO_OBJ) {
+            while ((t = js.proximo()) == LeitorJSON::CHAVE) {
+                string campo = js.texto();
+                t = js.proximo();
+                if (campo == "nodes" && t == LeitorJSON::INICIO_ARR) {
+                    while ((t = js.proximo()) == LeitorJSON::NUMERO) c.crit.nos.push_back((uint64_t)js.inteiro());
+                    if (t != LeitorJSON::FIM_ARR) return false;
+                } else if (campo == "edges" && t == LeitorJSON::INICIO_ARR) {
+                    while ((t = js.proximo()) == LeitorJSON::INICIO_ARR) {
+                        if (js.proximo() != LeitorJSON::NUMERO) return false;
+                        uint64_t u = (uint64_t)js.inteiro();
+                        if (js.proximo() != LeitorJSON::NUMERO) return false;
+                        c.crit.arestas.emplace_back(u, (uint64_t)js.inteiro());
+                        if (js.proximo() != LeitorJSON::FIM_ARR) return false;
+                    }
+                    if (t != LeitorJSON::FIM_ARR) return false;
+                } else if (campo == "stats" && t == LeitorJSON::INICIO_OBJ) {
+                    while ((t = js.proximo()) == LeitorJSON::CHAVE) {
+                        string est = js.texto();
+                        t = js.proximo();
+                        if (t != LeitorJSON::NUMERO) js.pular();
+                        else if (est == "sources") c.crit.inicios = (uint64_t)js.inteiro();
+                        else if (est == "sinks") c.crit.fins = (uint64_t)js.inteiro();
+                        else if (est == "paths") c.crit.caminhos = js.inteiro();
+                        else if (est == "duration") c.duracao = js.real();
+                    }
+                    if (t != LeitorJSON::FIM_OBJ) return false;
+                } else {
+                    js.pular();
+                }
+            }
+            if (t != LeitorJSON::FIM_OBJ) return false;
+        } else {
+            js.pular();
+        }
+    }
+    if (t != LeitorJSON::FIM_OBJ) return false;
+
+    // índice negativo no arquivo vira um valor >= n e é recusado junto com os grandes
+    IndiceRotulos idx(c.rotulos);
+    for (auto& a : arestasRot) {
+        uint64_t u = (uint64_t)idx.buscar(a.first), v = (uint64_t)idx.buscar(a.second);
+        if (u == Cronograma::NENHUM || v == Cronograma::NENHUM) return false;
+        c.arestas.emplace_back(u, v);
+    }
+    for (auto& r : caminhoRot) {
+        uint64_t u = (uint64_t)idx.buscar(r);
+        if (u == Cronograma::NENHUM) return false;
+        c.caminho.push_back(u);
+    }
+    uint64_t n = c.rotulos.size();
+    for (uint64_t u : c.crit.nos) if (u >= n) return false;
+    for (auto& a : c.crit.arestas)
+        if (a.first >= n || a.second >= n) return false;
+    return true;
+}
+
+// ---------------- gerar delta entre duas versões do cronograma ----------------
+// Escreve apenas o que mudou de 'ant' para 'atual': nós e arestas incluídos/removidos,
+// campos alterados de cada nó e as entradas/saídas do subgrafo crítico. O grafo.html
+// aplica o delta direto nos DataSets, sem recarregar nem refazer o layout inteiro.
+// Os tempos são comparados em double (NaN de campo ausente conta sempre como mudança)
+// e escritos de volta em Tempo, com o mesmo texto do grafo.json.
+constexpr bool campoAlterado(double a, double b) { return !(a == b); }
+static_assert(campoAlterado(1.5, 1.7) && campoAlterado(numeric_limits<double>::quiet_NaN(), 0.0) &&
+              campoAlterado(numeric_limits<double>::quiet_NaN(), numeric_limits<double>::quiet_NaN()) &&
+              !campoAlterado(2.0, 2.0), "fração de duração tem que entrar no delta");
+
+template <class Tempo>
+void gerarDeltaJSON(const Cronograma& ant, const Cronograma& atual, const string& caminhoArq) {
+    const uint64_t NENHUM = Cronograma::NENHUM;
+    size_t nAnt = ant.rotulos.size(), nAtual = atual.rotulos.size();
+    IndiceRotulos idxAtual(atual.rotulos);
+
+    // mapa índice antigo -> índice atual (NENHUM se o nó foi removido)
+    vector<uint64_t> mapa(nAnt, NENHUM);
+    vector<char> existia(nAtual, 0);
+    for (size_t i = 0; i < nAnt; i++) {
+        mapa[i] = (uint64_t)idxAtual.buscar(ant.rotulos[i]);
+        if (mapa[i] != NENHUM) existia[mapa[i]] = 1;
+    }
+
+    using Arestas = unordered_set<pair<uint64_t, uint64_t>, HashAresta>;
+    auto conjuntoArestas = [&](const auto& arestas, Arestas& s) {
+        s.reserve(arestas.size());
+        for (auto& a : arestas) s.insert(a);
+    };
+
+    // arestas antigas com algum extremo removido saem direto na lista de remoção
+    auto separar = [&](const auto& arestasAnt, Arestas& mantidas,
+                       vector<pair<string_view, string_view>>& removidas) {
+        for (auto& a : arestasAnt) {
+            uint64_t u = mapa[a.first], v = mapa[a.second];
+            if (u == NENHUM || v == NENHUM) removidas.emplace_back(ant.rotulos[a.first], ant.rotulos[a.second]);
+            else mantidas.emplace(u, v);
+        }
+    };
+    auto diferenca = [&](const auto& arestasAtuais, const Arestas& antigas,
+                         const Arestas& atuais, const auto& arestasAnt,
+                         vector<pair<string_view, string_view>>& incluidas, vector<pair<string_view, string_view>>& removidas) {
+        for (auto& a : arestasAtuais)
+            if (!antigas.count({a.first, a.second}))
+                incluidas.emplace_back(atual.rotulos[a.first], atual.rotulos[a.second]);
+        for (auto& a : arestasAnt) {
+            uint64_t u = mapa[a.first], v = mapa[a.second];
+            if (u != NENHUM && v != NENHUM && !atuais.count({u, v}))
+                removidas.emplace_back(ant.rotulos[a.first], ant.rotulos[a.second]);
+        }
+    };
+
+    Arestas arestasAntigas, arestasAtuais;
+    vector<pair<string_view, string_view>> arestasIncl, arestasRem;
+    separar(ant.arestas, arestasAntigas, arestasRem);
+    conjuntoArestas(atual.arestas, arestasAtuais);
+    diferenca(atual.arestas, arestasAntigas, arestasAtuais, ant.arestas, arestasIncl, arestasRem);
+
+    Arestas critAntigas, critAtuais;
+    vector<pair<string_view, string_view>> critIncl, critRem;
+    separar(ant.crit.arestas, critAntigas, critRem);
+    conjuntoArestas(atual.crit.arestas, critAtuais);
+    diferenca(atual.crit.arestas, critAntigas, critAtuais, ant.crit.arestas, critIncl, critRem);
+
+    vector<char> noCritAnt(nAtual, 0), noCritAtual(nAtual, 0);
+    vector<string_view> critNosRem;
+    for (uint64_t u : ant.crit.nos) {
+        if (mapa[u] == NENHUM) critNosRem.push_back(ant.rotulos[u]);
+        else noCritAnt[mapa[u]] = 1;
+    }
+    for (uint64_t u : atual.crit.nos) noCritAtual[u] = 1;
+
+    EscritorBuffer f(caminhoArq, EscritorBuffer::Atomico{});
+    if (!f.aberto()) {
+        cerr << "Aviso: não foi possível criar " << caminhoArq << ".\n";
+        return;
+    }
+
+    auto tempo = [](double d) { return TempoTraits<Tempo>::deReal(d); };
+    auto listaRotulos = [&](const vector<string_view>& v) {
+        f << "[";
+        for (size_t i = 0; i < v.size(); i++) f << (i ? ", " : "") << json(v[i]);
+        f << "]";
+    };
+    auto listaPares = [&](const vector<pair<string_view, string_view>>& v) {
+        f << "[";
+        for (size_t i = 0; i < v.size(); i++)
+            f << (i ? ", " : "") << "[" << json(v[i].first) << ", " << json(v[i].second) << "]";
+        f << "]";
+    };
+
+    f << "{\n";
+    f << "  \"from_version\": " << ant.versao << ",\n";
+    f << "  \"to_version\": " << atual.versao << ",\n";
+
+    f << "  \"nodes\": {\n    \"add\": [";
+    bool first = true;
+    for (size_t i = 0; i < nAtual; i++) {
+        if (existia[i]) continue;
+        f << (first ? "\n" : ",\n");
+        first = false;
+        f << "      {\"id\": " << json(atual.rotulos[i]) << ", \"duration\": " << tempo(atual.dur[i])
+          << ", \"ES\": " << tempo(atual.ES[i]) << ", \"EF\": " << tempo(atual.EF[i])
+          << ", \"LS\": " << tempo(atual.LS[i]) << ", \"LF\": " << tempo(atual.LF[i]) << "}";
+    }
+    f << (first ? "],\n" : "\n    ],\n");
+
+    vector<string_view> nosRem;
+    for (size_t i = 0; i < nAnt; i++) if (mapa[i] == NENHUM) nosRem.push_back(ant.rotulos[i]);
+    f << "    \"remove\": ";
+    listaRotulos(nosRem);
+    f << ",\n";
+
+    // só os campos que mudaram em cada nó mantido
+    f << "    \"update\": [";
+    first = true;
+    for (size_t i = 0; i < nAnt; i++) {
+        uint64_t j = mapa[i];
+        if (j == NENHUM) continue;
+        const pair<const char*, pair<double, double>> campos[] = {
+            {"duration", {ant.dur[i], atual.dur[j]}},
+            {"ES", {ant.ES[i], atual.ES[j]}}, {"EF", {ant.EF[i], atual.EF[j]}},
+            {"LS", {ant.LS[i], atual.LS[j]}}, {"LF", {ant.LF[i], atual.LF[j]}},
+        };
+        bool mudou = false;
+        for (auto& c : campos) {
+            if (!campoAlterado(c.second.first, c.second.second)) continue;
+            if (!mudou) {
+                f << (first ? "\n" : ",\n") << "      {\"id\": " << json(atual.rotulos[j]);
+                first = false;
+                mudou = true;
+            }
+            f << ", \"" << c.first << "\": " << tempo(c.second.second);
+        }
+        if (mudou) f << "}";
+    }
+    f << (first ? "]\n" : "\n    ]\n");
+    f << "  },\n";
+
+    f << "  \"edges\": {\n    \"add\": ";
+    listaPares(arestasIncl);
+    f << ",\n    \"remove\": ";
+    listaPares(arestasRem);
+    f << "\n  },\n";
+
+    vector<string_view> critNosIncl;
+    for (size_t i = 0; i < nAtual; i++) {
+        if (noCritAtual[i] && !noCritAnt[i]) critNosIncl.push_back(atual.rotulos[i]);
+        if (!noCritAtual[i] && noCritAnt[i]) critNosRem.push_back(atual.rotulos[i]);
+    }
+    f << "  \"critical_subgraph\": {\n    \"add\": ";
+    listaRotulos(critNosIncl);
+    f << ",\n    \"remove\": ";
+    listaRotulos(critNosRem);
+    f << ",\n    \"edges_add\": ";
+    listaPares(critIncl);
+    f << ",\n    \"edges_remove\": ";
+    listaPares(critRem);
+    f << ",\n    \"stats\": {\"nodes\": " << atual.crit.nos.size() << ", \"edges\": " << atual.crit.arestas.size()
+      << ", \"sources\": " << atual.crit.inicios << ", \"sinks\": " << atual.crit.fins
+      << ", \"paths\": " << atual.crit.caminhos << ", \"duration\": " << tempo(atual.duracao) << "}";
+    f << "\n  }\n";
+    f << "}\n";
+    if (!f.fechar()) cerr << "Aviso: falha ao escrever " << caminhoArq << ".\n";
+}
+
+// grafo.json na versão seguinte à já gravada e, se havia uma, grafo.delta.json entre
+// as duas. 'gravado' é a versão anterior quando quem chama já a tem em memória (nulo:
+// lida de grafo.json). Retorna o cronograma gravado.
+template <class Idx, class Adj, class Tempo>
+Cronograma gravarVisualizacao(const Grafo<Idx, Adj>& g, const Rotulos& rotulos, Duracoes<Tempo> dur,
+                              const Vetor<Idx>& caminhoCrit, const SubgrafoCritico<Idx>& sub,
+                              const Vetor<Tempo>& ES, const Vetor<Tempo>& EF,
+                              const Vetor<Tempo>& LS, const Vetor<Tempo>& LF, Tempo durProjeto,
+                              const Cronograma* gravado = nullptr) {
+    // a versão anterior do grafo.json serve de base para o delta da visualização
+    Cronograma lido;
+    bool temAnterior = gravado || lerCronogramaJSON("grafo.json", lido);
+    const Cronograma& anterior = gravado ? *gravado : lido;
+    Cronograma atual = montarCronograma(g, rotulos, dur, caminhoCrit, sub, ES, EF, LS, LF, durProjeto);
+    atual.versao = temAnterior ? anterior.versao + 1 : 1;
+
+    gerarJSON_vis(g, rotulos, dur, caminhoCrit, sub, ES, EF, LS, LF, durProjeto, atual.versao);
+    cout << "Arquivo 'grafo.json' gerado (versão " << atual.versao << ").\n";
+    if (temAnterior) {
+        gerarDeltaJSON<Tempo>(anterior, atual, "grafo.delta.json");
+        cout << "Arquivo 'grafo.delta.json' gerado (versão " << anterior.versao << " -> " << atual.versao << ").\n";
+    }
+    return atual;
+}
+
+// ---------------- comparação de cronogramas ----------------
+// Casa as atividades de 'base' e 'atual' pelo índice de rótulos e percorre a
+// ordem alfabética de rótulos em blocos paralelos. Cada bloco gera suas linhas e
+// a concatenação mantém a ordem, então o relatório sai igual com qualquer nº de threads.
+struct Comparacao {
+    using Indices = vector<uint64_t>;
+    Indices mapa;                                 // índice base -> atual (NENHUM = removida)
+    Indices inverso;                              // índice atual -> base (NENHUM = incluída)
+    Indices alteradas;                            // índices em atual, ordem de rótulo
+    Indices incluidas;                            // índices em atual
+    Indices removidas;                            // índices em base
+    Indices entraramCrit;                         // índices em atual
+    Indices sairamCrit;                           // índices em base
+    vector<pair<uint64_t, uint64_t>> arestasIncl; // em atual
+    vector<pair<uint64_t, uint64_t>> arestasRem;  // em base
+};
+
+Comparacao compararCronogramas(const Cronograma& base, const Cronograma& atual) {
+    const uint64_t NENHUM = Cronograma::NENHUM;
+    Comparacao cmp;
+    size_t nBase = base.rotulos.size(), nAtual = atual.rotulos.size();
+    IndiceRotulos idxAtual(atual.rotulos);
+
+    cmp.mapa.assign(nBase, NENHUM);
+    cmp.inverso.assign(nAtual, NENHUM);
+    Comparacao::Indices& inverso = cmp.inverso;
+    paraleloBlocos(nBase, [&](size_t ini, size_t fim, size_t) {
+        for (size_t i = ini; i < fim; i++) cmp.mapa[i] = (uint64_t)idxAtual.buscar(base.rotulos[i]);
+    });
+    for (size_t i = 0; i < nBase; i++) if (cmp.mapa[i] != NENHUM) inverso[cmp.mapa[i]] = i;
+
+    auto porRotulo = [](const Rotulos& r) {
+        return [&r](uint64_t a, uint64_t b) { return string_view(r[a]) < string_view(r[b]); };
+    };
+    Comparacao::Indices ordem(nAtual);
+    iota(ordem.begin(), ordem.end(), uint64_t{0});
+    sort(ordem.begin(), ordem.end(), porRotulo(atual.rotulos));
+
+    // crítica = nó do subgrafo crítico gravado, calculado com a igualdade da instanciação
+    // que gerou o cronograma; grafo.json sem ele cai na folga zero em double
+    auto marcasCriticas = [](const Cronograma& c) {
+        vector<char> m(c.rotulos.size(), 0);
+        if (c.crit.nos.empty())
+            for (size_t i = 0; i < m.size(); i++) m[i] = semFolga(c.LS[i], c.ES[i]);
+        for (uint64_t u : c.crit.nos) m[u] = 1;
+        return m;
+    };
+    const vector<char> critBase = marcasCriticas(base), critAtual = marcasCriticas(atual);
+    auto critico = [&](const Cronograma& c, uint64_t i) { return (&c == &base ? critBase : critAtual)[i] != 0; };
+
+    struct Parcial { Comparacao::Indices alteradas, incluidas, entraram, sairam; };
+    size_t nt = max<size_t>(1, thread::hardware_concurrency());
+    vector<Parcial> parciais(nt);
+    paraleloBlocos(ordem.size(), [&](size_t ini, size_t fim, size_t t) {
+        Parcial& p = parciais[t];
+        for (size_t k = ini; k < fim; k++) {
+            uint64_t j = ordem[k], i = inverso[j];
+            if (i == NENHUM) {
+                p.incluidas.push_back(j);
+                if (critico(atual, j)) p.entraram.push_back(j);
+                continue;
+            }
+            if (base.dur[i] != atual.dur[j] || base.ES[i] != atual.ES[j] || base.EF[i] != atual.EF[j]
+                || base.LS[i] != atual.LS[j] || base.LF[i] != atual.LF[j])
+                p.alteradas.push_back(j);
+            bool cb = critico(base, i), ca = critico(atual, j);
+            if (ca && !cb) p.entraram.push_back(j);
+            if (cb && !ca) p.sairam.push_back(i);
+        }
+    });
+    for (auto& p : parciais) {
+        cmp.alteradas.insert(cmp.alteradas.end(), p.alteradas.begin(), p.alteradas.end());
+        cmp.incluidas.insert(cmp.incluidas.end(), p.incluidas.begin(), p.incluidas.end());
+        cmp.entraramCrit.insert(cmp.entraramCrit.end(), p.entraram.begin(), p.entraram.end());
+        cmp.sairamCrit.insert(cmp.sairamCrit.end(), p.sairam.begin(), p.sairam.end());
+    }
+
+    // removidas (e críticas que saíram junto) na ordem de rótulo da base
+    for (size_t i = 0; i < nBase; i++) if (cmp.mapa[i] == NENHUM) cmp.removidas.push_back(i);
+    sort(cmp.removidas.begin(), cmp.removidas.end(), porRotulo(base.rotulos));
+    Comparacao::Indices sairamRemovidas;
+    for (uint64_t i : cmp.removidas) if (critico(base, i)) sairamRemovidas.push_back(i);
+    Comparacao::Indices sairam;
+    merge(cmp.sairamCrit.begin(), cmp.sairamCrit.end(), sairamRemovidas.begin(), sairamRemovidas.end(),
+          back_inserter(sairam), porRotulo(base.rotulos));
+    cmp.sairamCrit.swap(sairam);
+
+    // arestas: leva as da base para os índices atuais e compara listas ordenadas
+    vector<pair<uint64_t, uint64_t>> arestasBase, arestasAtual = atual.arestas;
+    for (auto& a : base.arestas) {
+        uint64_t u = cmp.mapa[a.first], v = cmp.mapa[a.second];
+        if (u == NENHUM || v == NENHUM) cmp.arestasRem.push_back(a);
+        else arestasBase.emplace_back(u, v);
+    }
+    sort(arestasBase.begin(), arestasBase.end());
+    sort(arestasAtual.begin(), arestasAtual.end());
+    set_difference(arestasAtual.begin(), arestasAtual.end(), arestasBase.begin(), arestasBase.end(),
+                   back_inserter(cmp.arestasIncl));
+    vector<pair<uint64_t, uint64_t>> remMantidos;
+    set_difference(arestasBase.begin(), arestasBase.end(), arestasAtual.begin(), arestasAtual.end(),
+                   back_inserter(remMantidos));
+    for (auto& a : remMantidos) cmp.arestasRem.emplace_back(inverso[a.first], inverso[a.second]);
+    return cmp;
+}
+
+void imprimirComparacao(const Cronograma& base, const Cronograma& atual, const Comparacao& cmp) {
+    EscritorBuffer out(stdout);
+    char linha[256];
+    auto delta = [&](double a, double b, char* dst, size_t tam) {
+        if (isnan(a) || isnan(b)) snprintf(dst, tam, "?");
+        else snprintf(dst, tam, "%+.15g", b - a);
+    };
+    auto duracao = [](const Cronograma& c) {
+        double d = 0;
+        for (double ef : c.EF) if (!isnan(ef)) d = max(d, ef);
+        return d;
+    };
+    double durBase = duracao(base), durAtual = duracao(atual);
+
+    out << "\n=== Comparação de cronogramas (base v" << base.versao << " -> atual v" << atual.versao << ") ===\n";
+    delta(durBase, durAtual, linha, sizeof(linha));
+    out << "Duração do projeto: " << durBase << " -> " << durAtual << " (" << linha << ")\n";
+    out << "Atividades: " << cmp.alteradas.size() << " alterada(s), " << cmp.incluidas.size()
+        << " incluída(s), " << cmp.removidas.size() << " removida(s)\n";
+
+    if (!cmp.alteradas.empty()) {
+        out << "\nDeslocamentos (atual - base; positivo = atraso):\n";
+        out << "Atv        | Dur  | ES   | EF   | LS   | LF   | Folga\n";
+        out << "-------------------------------------------------------\n";
+        for (uint64_t j : cmp.alteradas) {
+            uint64_t i = cmp.inverso[j];
+            char d[6][32];
+            delta(base.dur[i], atual.dur[j], d[0], 32);
+            delta(base.ES[i], atual.ES[j], d[1], 32);
+            delta(base.EF[i], atual.EF[j], d[2], 32);
+            delta(base.LS[i], atual.LS[j], d[3], 32);
+            delta(base.LF[i], atual.LF[j], d[4], 32);
+            if (isnan(base.LS[i]) || isnan(base.ES[i])) snprintf(d[5], 32, "?");
+            else snprintf(d[5], 32, "%+.15g", (atual.LS[j] - atual.ES[j]) - (base.LS[i] - base.ES[i]));
+            Rotulo rot = atual.rotulos[j];
+            snprintf(linha, sizeof(linha), "%-10.*s | %-4s | %-4s | %-4s | %-4s | %-4s | %s\n",
+                     (int)rot.size(), rot.data(), d[0], d[1], d[2], d[3], d[4], d[5]);
+            out << linha;
+        }
+    }
+
+    auto lista = [&](const char* titulo, const Comparacao::Indices& v, const Cronograma& c) {
+        if (v.empty()) return;
+        out << titulo << " (" << v.size() << "): ";
+        for (size_t k = 0; k < v.size(); k++) out << (k ? " " : "") << c.rotulos[v[k]];
+        out << "\n";
+    };
+    auto listaArestas = [&](const char* titulo, const vector<pair<uint64_t, uint64_t>>& v, const Cronograma& c) {
+        if (v.empty()) return;
+        out << titulo << " (" << v.size() << "): ";
+        for (size_t k = 0; k < v.size(); k++)
+            out << (k ? ", " : "") << c.rotulos[v[k].first] << "->" << c.rotulos[v[k].second];
+        out << "\n";
+    };
+    out << "\n";
+    lista("Incluídas", cmp.incluidas, atual);
+    lista("Removidas", cmp.removidas, base);
+    lista("Entraram no conjunto crítico", cmp.entraramCrit, atual);
+    lista("Saíram do conjunto crítico", cmp.sairamCrit, base);
+    listaArestas("Arestas incluídas", cmp.arestasIncl, atual);
+    listaArestas("Arestas removidas", cmp.arestasRem, base);
+    if (cmp.alteradas.empty() && cmp.incluidas.empty() && cmp.removidas.empty()
+        && cmp.arestasIncl.empty() && cmp.arestasRem.empty())
+        out << "Cronogramas idênticos.\n";
+}
+
+// ---------------- índice de intervalos (janelas de tempo) ----------------
+// Treap ordenada por (início, id) e aumentada com o maior fim da subárvore.
+// Intervalos semiabertos [ini, fim); os de duração zero valem como [ini, proximo(ini)),
+// para que marcos apareçam na janela que contém o instante. Consulta visita só
+// subárvores que podem ter resposta: O(log n + k) esperado; inserir, remover e
+// atualizar custam O(log n) esperado, então o índice acompanha mudanças pontuais
+// no cronograma sem ser reconstruído.
+template <class Idx, class Tempo>
+class IndiceIntervalos {
+public:
+    static constexpr Idx NENHUM = numeric_limits<Idx>::max();
+
+    void construir(const Vetor<Tempo>& ini, const Vetor<Tempo>& fim) {
+        Idx n = (Idx)ini.size();
+        nos.assign(n, No());
+        presente.assign(n, 0);
+        raiz = NENHUM;
+        quantidade = 0;
+        for (Idx i = 0; i < n; i++) inserir(i, ini[i], fim[i]);
+    }
+
+    void inserir(Idx id, Tempo ini, Tempo fim) {
+        if (id >= nos.size()) { nos.resize((size_t)id + 1); presente.resize((size_t)id + 1, 0); }
+        if (presente[id]) remover(id);
+        No& x = nos[id];
+        x.ini = ini;
+        x.fim = max(fim, TempoTraits<Tempo>::proximo(ini));
+        x.maxFim = x.fim;
+        x.prio = prioridade(id);
+        x.esq = x.dir = NENHUM;
+        Idx l, r;
+        dividir(raiz, ini, id, l, r);
+        raiz = juntar(juntar(l, id), r);
+        presente[id] = 1;
+        quantidade++;
+    }
+
+    void remover(Idx id) {
+        if (id >= nos.size() || !presente[id]) return;
+        Idx l, meio, r;
+        dividir(raiz, nos[id].ini, id, l, r);       // l: chaves < (ini, id)
+        dividir(r, nos[id].ini, id + 1, meio, r);   // meio: só o próprio id
+        raiz = juntar(l, r);
+        presente[id] = 0;
+        quantidade--;
+    }
+
+    void atualizar(Idx id, Tempo ini, Tempo fim) { inserir(id, ini, fim); }  // inserir já remove o antigo
+
+    // Ids cujo intervalo intersecta [a, b), em ordem de início.
+    void consultar(Tempo a, Tempo b, vector<Idx>& saida) const { coletar(raiz, a, b, saida); }
+    // Ids cujo intervalo contém o instante t.
+    void perfurar(Tempo t, vector<Idx>& saida) const { coletar(raiz, t, TempoTraits<Tempo>::proximo(t), saida); }
+
+    size_t tamanho() const { return quantidade; }
+
+private:
+    struct No {
+        Tempo ini{}, fim{}, maxFim{};
+        uint32_t prio = 0;
+        Idx esq = NENHUM, dir = NENHUM;
+    };
+    vector<No> nos;   // indexado pelo id da atividade
+    vector<char> presente;
+    Idx raiz = NENHUM;
+    size_t quantidade = 0;
+
+    static uint32_t prioridade(Idx id) {
+        uint64_t z = (uint64_t)id + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return (uint32_t)(z ^ (z >> 31));
+    }
+    bool menor(Idx t, Tempo ini, Idx id) const {
+        return nos[t].ini < ini || (nos[t].ini == ini && t < id);
+    }
+    void recalcular(Idx t) {
+        No& x = nos[t];
+        x.maxFim = x.fim;
+        if (x.esq != NENHUM) x.maxFim = max(x.maxFim, nos[x.esq].maxFim);
+        if (x.dir != NENHUM) x.maxFim = max(x.maxFim, nos[x.dir].maxFim);
+    }
+    // l recebe as chaves < (ini, id); r, as demais
+    void dividir(Idx t, Tempo ini, Idx id, Idx& l, Idx& r) {
+        if (t == NENHUM) { l = r = NENHUM; return; }
+        if (menor(t, ini, id)) {
+            dividir(nos[t].dir, ini, id, nos[t].dir, r);
+            l = t;
+        } else {
+            dividir(nos[t].esq, ini, id, l, nos[t].esq);
+            r = t;
+        }
+        recalcular(t);
+    }
+    Idx juntar(Idx l, Idx r) {
+        if (l == NENHUM) return r;
+        if (r == NENHUM) return l;
+        if (nos[l].prio > nos[r].prio) {
+            nos[l].dir = juntar(nos[l].dir, r);
+            recalcular(l);
+            return l;
+        }
+        nos[r].esq = juntar(l, nos[r].esq);
+        recalcular(r);
+        return r;
+    }
+    void coletar(Idx t, Tempo a, Tempo b, vector<Idx>& saida) const {
+        if (t == NENHUM || nos[t].maxFim <= a) return;
+        coletar(nos[t].esq, a, b, saida);
+        if (nos[t].ini >= b) return;   // este nó e toda a direita começam depois da janela
+        if (nos[t].fim > a) saida.push_back(t);
+        coletar(nos[t].dir, a, b, saida);
+    }
+};
+
+// Janela [ES, LF) de cada atividade: do início mais cedo ao término mais tarde.
+template <class Idx, class Tempo>
+void indexarJanelas(IndiceIntervalos<Idx, Tempo>& indice, const Vetor<Tempo>& ES, const Vetor<Tempo>& LF) {
+    indice.construir(ES, LF);
+}
+
+// Reindexa só as atividades cujo ES ou LF mudou após um recálculo.
+template <class Idx, class Tempo>
+void atualizarJanelas(IndiceIntervalos<Idx, Tempo>& indice, const Vetor<Idx>& alteradas,
+                      const Vetor<Tempo>& ES, const Vetor<Tempo>& LF) {
+    for (Idx i : alteradas) indice.atualizar(i, ES[i], LF[i]);
+}
+
+// 'achados' vem de consultar(a, b) ou, num instante, de perfurar(a) com b = proximo(a).
+// 'rotulos[i]' dá o texto (size/data) da atividade i: Rotulos ou o que a sessão usa.
+template <class Idx, class Tempo, class R>
+void imprimirJanela(const vector<Idx>& achados, Tempo a, Tempo b, const R& rotulos,
+                    const Vetor<Tempo>& ES, const Vetor<Tempo>& EF,
+                    const Vetor<Tempo>& LS, const Vetor<Tempo>& LF) {
+    EscritorBuffer out(stdout);
+    char linha[256], t[6][32];
+    out << "\nAtividades com janela [ES, LF) em [" << a << ", " << b << "): " << achados.size() << "\n";
+    if (achados.empty()) return;
+    out << "Atv        | ES   | EF   | LS   | LF   | Folga | Na janela\n";
+    out << "-------------------------------------------------------------\n";
+    for (Idx i : achados) {
+        // em execução (cedo) se [ES, EF) toca a janela; com folga se [EF, LF) toca
+        bool executa = ES[i] < b && max(EF[i], TempoTraits<Tempo>::proximo(ES[i])) > a;
+        bool comFolga = LF[i] > EF[i] && EF[i] < b && LF[i] > a;
+        const char* estado = executa && comFolga ? "execução + folga" : executa ? "execução" : "folga";
+        auto rot = rotulos[i];
+        snprintf(linha, sizeof(linha), "%-10.*s | %-4s | %-4s | %-4s | %-4s | %-5s | %s\n",
+                 (int)rot.size(), rot.data(), textoTempo(ES[i], t[0]), textoTempo(EF[i], t[1]),
+                 textoTempo(LS[i], t[2]), textoTempo(LF[i], t[3]), textoTempo(LS[i] - ES[i], t[4]), estado);
+        out << linha;
+    }
+}
+
+// ---------------- relatórios (seleção parcial e paginação) ----------------
+// Com dezenas de milhares de atividades, imprimir uma linha por atividade custa mais
+// que o cálculo. Rankings e páginas saem de seleção parcial sobre índices: as k
+// primeiras linhas por um heap limitado (O(V log k), memória O(k)); uma página no meio
+// por nth_element até o início dela e ordenação só da página (O(V + k log k)).
+// Empates são desfeitos pelo índice, então a mesma página sai sempre igual.
+enum class Coluna { ATV, DUR, ES, EF, LS, LF, FOLGA, GRAU };
+
+struct Ordenacao {
+    Coluna coluna = Coluna::ATV;
+    bool decrescente = false;
+};
+
+// "dur", "-folga" ('-' = decrescente); false se a coluna não existe.
+bool lerOrdenacao(string_view s, Ordenacao& o) {
+    static const pair<string_view, Coluna> nomes[] = {
+        {"atv", Coluna::ATV}, {"dur", Coluna::DUR}, {"es", Coluna::ES},       {"ef", Coluna::EF},
+        {"ls", Coluna::LS},   {"lf", Coluna::LF},   {"folga", Coluna::FOLGA}, {"grau", Coluna::GRAU}};
+    o.decrescente = !s.empty() && s[0] == '-';
+    if (o.decrescente) s.remove_prefix(1);
+    for (auto& [nome, c] : nomes)
+        if (s == nome) {
+            o.coluna = c;
+            return true;
+        }
+    return false;
+}
+
+// Rankings de --top: menor folga, maiores durações, maior número de sucessores.
+bool lerCriterioTopo(string_view s, Ordenacao& o) {
+    if (s == "folga") o = {Coluna::FOLGA, false};
+    else if (s == "duracao") o = {Coluna::DUR, true};
+    else if (s == "grau") o = {Coluna::GRAU, true};
+    else return false;
+    return true;
+}
+
+template <class Idx, class Tempo, class Adj>
+class Relatorio {
+public:
+    Relatorio(const Grafo<Idx, Adj>& g, const Rotulos& rotulos, Duracoes<Tempo> dur, const Vetor<Tempo>& ES,
+              const Vetor<Tempo>& EF, const Vetor<Tempo>& LS, const Vetor<Tempo>& LF, const Vetor<Tempo>& folga)
+        : g(g), rotulos(rotulos), dur(dur), ES(ES), EF(EF), LS(LS), LF(LF), folga(folga) {}
+
+    // Índices das linhas [ini, fim) da tabela na ordem pedida.
+    vector<Idx> selecionar(Ordenacao o, size_t ini, size_t fim) const {
+        size_t n = g.qntV;
+        fim = min(fim, n);
+        vector<Idx> saida;
+        if (ini >= fim) return saida;
+        auto antes = [&](Idx a, Idx b) {
+            int c = comparar(o.coluna, a, b);
+            if (c) return o.decrescente ? c > 0 : c < 0;
+            return a < b;
+        };
+        if (o.coluna == Coluna::ATV) {   // já é a ordem dos índices
+            for (size_t k = ini; k < fim; k++) saida.push_back((Idx)(o.decrescente ? n - 1 - k : k));
+        } else if (ini == 0 && fim <= n / 8) {
+            // heap de máximo com as 'fim' melhores até aqui: o topo é a pior delas
+            saida.reserve(fim);
+            for (size_t i = 0; i < n; i++) {
+                if (saida.size() < fim) {
+                    saida.push_back((Idx)i);
+                    push_heap(saida.begin(), saida.end(), antes);
+                } else if (antes((Idx)i, saida.front())) {
+                    pop_heap(saida.begin(), saida.end(), antes);
+                    saida.back() = (Idx)i;
+                    push_heap(saida.begin(), saida.end(), antes);
+                }
+            }
+            sort_heap(saida.begin(), saida.end(), antes);
+        } else {
+            vector<Idx> todos(n);
+            iota(todos.begin(), todos.end(), Idx{0});
+            if (ini) nth_element(todos.begin(), todos.begin() + ini, todos.end(), antes);
+            partial_sort(todos.begin() + ini, todos.begin() + fim, todos.end(), antes);
+            saida.assign(todos.begin() + ini, todos.begin() + fim);
+        }
+        return saida;
+    }
+
+    // Página 'pagina' (a partir de 1) com 'linhas' linhas; com uma página só e na
+    // ordem de entrada, sai exatamente a tabela completa.
+    void imprimirTabela(EscritorBuffer& out, Ordenacao o, size_t pagina, size_t linhas) const {
+        size_t n = g.qntV, paginas = (n + linhas - 1) / linhas;
+        bool comGrau = o.coluna == Coluna::GRAU;
+        out << "\nTabela PERT/CPM";
+        if (o.coluna != Coluna::ATV || o.decrescente) out << " (ordenada por " << (o.decrescente ? "-" : "") << nome(o.coluna) << ")";
+        out << ":\n";
+        cabecalho(out, comGrau);
+        size_t ini = pagina <= paginas ? (pagina - 1) * linhas : n;   // além da última: página vazia
+        imprimirLinhas(out, selecionar(o, ini, ini + linhas), comGrau);
+        out << "-------------------------------------------\n";
+        if (paginas > 1)
+            out << "Página " << pagina << " de " << paginas << " (" << n << " atividades, " << linhas
+                << " por página; --pagina M, --linhas N, --ordenar COLUNA)\n";
+    }
+
+    void imprimirTopo(EscritorBuffer& out, Ordenacao o, size_t k) const {
+        vector<Idx> sel = selecionar(o, 0, k);
+        out << "\nTop " << sel.size() << " por "
+            << (o.coluna == Coluna::FOLGA ? "menor folga" : o.coluna == Coluna::DUR ? "maior duração" : "mais sucessores")
+            << ":\n";
+        cabecalho(out, true);
+        imprimirLinhas(out, sel, true);
+        out << "-------------------------------------------\n";
+    }
+
+private:
+    const Grafo<Idx, Adj>& g;
+    const Rotulos& rotulos;
+    Duracoes<Tempo> dur;
+    const Vetor<Tempo>&ES, &EF, &LS, &LF, &folga;
+
+    static const char* nome(Coluna c) {
+        static const char* nomes[] = {"atv", "dur", "es", "ef", "ls", "lf", "folga", "grau"};
+        return nomes[(int)c];
+    }
+
+    int comparar(Coluna c, Idx a, Idx b) const {
+        auto cmp = [](auto x, auto y) { return (int)(x > y) - (int)(x < y); };
+        switch (c) {
+            case Coluna::DUR: return cmp(dur[a], dur[b]);
+            case Coluna::ES: return cmp(ES[a], ES[b]);
+            case Coluna::EF: return cmp(EF[a], EF[b]);
+            case Coluna::LS: return cmp(LS[a], LS[b]);
+            case Coluna::LF: return cmp(LF[a], LF[b]);
+            case Coluna::FOLGA: return cmp(folga[a], folga[b]);
+            case Coluna::GRAU: return cmp((uint64_t)g.suc.grau(a), (uint64_t)g.suc.grau(b));
+            default: return cmp(a, b);
+        }
+    }
+
+    static void cabecalho(EscritorBuffer& out, bool comGrau) {
+        out << (comGrau ? "Atv | Dur | ES | EF | LS | LF | Folga | Suc\n" : "Atv | Dur | ES | EF | LS | LF | Folga\n");
+        out << "-------------------------------------------\n";
+    }
+
+    void imprimirLinhas(EscritorBuffer& out, const vector<Idx>& linhas, bool comGrau) const {
+        char linha[256], t[6][32];
+        for (Idx i : linhas) {
+            Rotulo rot = rotulos[i];
+            out << rot;
+            for (size_t k = rot.size(); k < 3; k++) out << ' ';
+            snprintf(linha, sizeof(linha), " | %-3s | %-3s | %-3s | %-3s | %-3s | %-3s", textoTempo(dur[i], t[0]),
+                     textoTempo(ES[i], t[1]), textoTempo(EF[i], t[2]), textoTempo(LS[i], t[3]),
+                     textoTempo(LF[i], t[4]), textoTempo(folga[i], t[5]));
+            out << linha;
+            if (comGrau) out << " | " << (uint64_t)g.suc.grau(i);
+            out << '\n';
+        }
+    }
+};
+
+// ---------------- curvas S (custo e recurso no tempo) ----------------
+// Custo e recurso acumulados nas fronteiras k*P (k = 0..K), com as atividades em
+// [ES, EF) (curva cedo) e em [LS, LF) (curva tarde). O custo se espalha por igual na
+// duração; o recurso é uma taxa (unidades por unidade de tempo). Em vez de percorrer
+// cada período de cada atividade (O(V·K)), cada atividade vira uma rampa r·max(0, t - s)
+// que começa em s e outra que a cancela em e. Indexando pela primeira fronteira >= s,
+// o acumulado em kP é kP·ΣA - ΣB, com A += r e B += r·s: duas somas prefixadas de
+// arrays de diferenças. Cada thread espalha num array próprio; os arrays são somados
+// e prefixados em paralelo, O(V + K). Marco com custo entra como degrau em B.
+struct CurvasS {
+    double periodo = 0;
+    size_t periodos = 0;   // K; os vetores têm K + 1 fronteiras
+    vector<double> custoCedo, custoTarde, recursoCedo, recursoTarde;   // acumulados
+};
+
+struct DeltaCurva {
+    double a[4] = {}, b[4] = {};   // canais: custo cedo, custo tarde, recurso cedo, recurso tarde
+    DeltaCurva& operator+=(const DeltaCurva& o) {
+        for (int c = 0; c < 4; c++) { a[c] += o.a[c]; b[c] += o.b[c]; }
+        return *this;
+    }
+};
+
+// Soma prefixada inclusiva em dois passos por blocos: total de cada bloco, deslocamento
+// serial entre blocos e de novo cada bloco com o seu deslocamento.
+template <class T>
+void somaPrefixaParalela(T* v, size_t n) {
+    vector<T> totais(max<size_t>(1, thread::hardware_concurrency()) + 1);
+    paraleloBlocos(n, [&](size_t ini, size_t fim, size_t t) {
+        T s{};
+        for (size_t i = ini; i < fim; i++) s += v[i];
+        totais[t + 1] = s;
+    });
+    for (size_t t = 1; t < totais.size(); t++) totais[t] += totais[t - 1];
+    paraleloBlocos(n, [&](size_t ini, size_t fim, size_t t) {
+        T s = totais[t];
+        for (size_t i = ini; i < fim; i++) { s += v[i]; v[i] = s; }
+    });
+}
+
+// 'custo' e 'recurso' por vértice; 'horizonte' é o maior EF/LF (duração do projeto).
+template <class Tempo>
+CurvasS calcularCurvasS(Faixa<const Tempo> ES, Faixa<const Tempo> EF, Faixa<const Tempo> LS, Faixa<const Tempo> LF,
+                        Faixa<const double> custo, Faixa<const double> recurso, Tempo horizonte, double periodo) {
+    CurvasS cs;
+    cs.periodo = periodo;
+    double h = TempoTraits<Tempo>::real(horizonte);
+    cs.periodos = max<size_t>(1, (size_t)ceil(h / periodo));
+    size_t K = cs.periodos, n = ES.size();
+    // primeira fronteira >= x; errar por uma no limite não muda nada, a rampa vale 0 ali
+    double inv = 1.0 / periodo;
+    auto fronteira = [&](double x) { return (size_t)min((double)K, max(0.0, ceil(x * inv))); };
+
+    vector<vector<DeltaCurva>> locais(max<size_t>(1, thread::hardware_concurrency()));
+    paraleloBlocos(n, [&](size_t ini, size_t fim, size_t t) {
+        vector<DeltaCurva>& d = locais[t];
+        d.assign(K + 1, DeltaCurva{});
+        auto rampa = [&](int c, double s, double e, double taxa, double degrau) {
+            if (e > s) {
+                size_t ks = fronteira(s), ke = fronteira(e);
+                d[ks].a[c] += taxa;
+                d[ks].b[c] += taxa * s;
+                d[ke].a[c] -= taxa;
+                d[ke].b[c] -= taxa * e;
+            } else if (degrau != 0) {   // marco: entra no período [kP, (k+1)P) que o contém
+                d[(size_t)min((double)K, max(0.0, floor(s / periodo) + 1))].b[c] -= degrau;
+            }
+        };
+        for (size_t i = ini; i < fim; i++) {
+            double es = TempoTraits<Tempo>::real(ES[i]), ef = TempoTraits<Tempo>::real(EF[i]);
+            double ls = TempoTraits<Tempo>::real(LS[i]), lf = TempoTraits<Tempo>::real(LF[i]);
+            rampa(0, es, ef, ef > es ? custo[i] / (ef - es) : 0, custo[i]);
+            rampa(1, ls, lf, lf > ls ? custo[i] / (lf - ls) : 0, custo[i]);
+            rampa(2, es, ef, recurso[i], 0);
+            rampa(3, ls, lf, recurso[i], 0);
+        }
+    }, max<size_t>(1 << 16, K + 1));   // threads * (K + 1) <= V: juntar custa no máximo o espalhar
+
+    // junta os arrays das threads, fronteira a fronteira
+    vector<DeltaCurva> soma(K + 1);
+    paraleloBlocos(K + 1, [&](size_t ini, size_t fim, size_t) {
+        for (const vector<DeltaCurva>& d : locais)
+            if (!d.empty())
+                for (size_t k = ini; k < fim; k++) soma[k] += d[k];
+    });
+    somaPrefixaParalela(soma.data(), soma.size());
+
+    vector<double>* saida[4] = {&cs.custoCedo, &cs.custoTarde, &cs.recursoCedo, &cs.recursoTarde};
+    for (int c = 0; c < 4; c++) saida[c]->resize(K + 1);
+    for (size_t k = 0; k <= K; k++)
+        for (int c = 0; c < 4; c++) (*saida[c])[k] = (double)k * periodo * soma[k].a[c] - soma[k].b[c];
+    return cs;
+}
+
+// CSV com um período por linha: custo do período e acumulado, recurso médio no período.
+bool gravarCurvasS(const string& caminho, const CurvasS& cs) {
+    FILE* f = fopen(caminho.c_str(), "w");
+    if (!f) return false;
+    fprintf(f, "periodo,inicio,fim,custo_cedo,custo_tarde,custo_cedo_acum,custo_tarde_acum,recurso_cedo,recurso_tarde\n");
+    for (size_t k = 0; k < cs.periodos; k++) {
+        double p = cs.periodo;
+        fprintf(f, "%zu,%g,%g,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f\n", k + 1, k * p, (k + 1) * p,
+                cs.custoCedo[k + 1] - cs.custoCedo[k], cs.custoTarde[k + 1] - cs.custoTarde[k],
+                cs.custoCedo[k + 1], cs.custoTarde[k + 1],
+                (cs.recursoCedo[k + 1] - cs.recursoCedo[k]) / p, (cs.recursoTarde[k + 1] - cs.recursoTarde[k]) / p);
+    }
+    return fclose(f) == 0;
+}
+
+// ---------------- escalonamento com recursos (SGS serial) ----------------
+// Uso dos recursos renováveis no tempo, como função escada: 'passos' guarda cada
+// instante em que o uso muda e o uso de cada recurso dali até o próximo passo; depois
+// do último o uso é zero. Reservar cria no máximo dois passos; liberar não os apaga.
+template <class Tempo>
+class PerfilRecursos {
+public:
+    explicit PerfilRecursos(vector<int64_t> capacidade) : cap(std::move(capacidade)) {
+        passos.emplace(Tempo{}, vector<int64_t>(cap.size(), 0));
+    }
+
+    // Se os usos [a, b) cabem em [t, t + d). Se não, [iniViol, fimViol) é o primeiro
+    // degrau que estouraria a capacidade. Duração zero não ocupa nada.
+    bool cabe(Tempo t, Tempo d, const UsoRecurso* a, const UsoRecurso* b, Tempo& iniViol, Tempo& fimViol) const {
+        if (a == b || !(Tempo{} < d)) return true;
+        Tempo fim = t + d;
+        for (auto it = prev(passos.upper_bound(t)); it != passos.end() && it->first < fim; ++it)
+            for (const UsoRecurso* u = a; u != b; u++)
+                if (it->second[u->recurso] + u->quantidade > cap[u->recurso]) {
+                    iniViol = it->first;
+                    fimViol = next(it)->first;   // existe: o último passo tem uso zero
+                    return false;
+                }
+        return true;
+    }
+
+    // sinal 1 reserva, -1 libera
+    void reservar(Tempo t, Tempo d, const UsoRecurso* a, const UsoRecurso* b, int64_t sinal) {
+        if (a == b || !(Tempo{} < d)) return;
+        auto fim = passo(t + d);
+        for (auto it = passo(t); it != fim; ++it)
+            for (const UsoRecurso* u = a; u != b; u++) it->second[u->recurso] += sinal * u->quantidade;
+    }
+
+    // Primeiro instante >= t em que cabe: o fim de cada degrau que estoura.
+    Tempo maisCedo(Tempo t, Tempo d, const UsoRecurso* a, const UsoRecurso* b) const {
+        Tempo ini, fim;
+        while (!cabe(t, d, a, b, ini, fim)) t = fim;
+        return t;
+    }
+
+    // Último instante em [lo, hi] em que cabe, terminando antes de cada degrau que
+    // estoura; 'lo' precisa caber.
+    Tempo maisTarde(Tempo lo, Tempo hi, Tempo d, const UsoRecurso* a, const UsoRecurso* b) const {
+        Tempo ini, fim, t = hi;
+        while (lo < t && !cabe(t, d, a, b, ini, fim)) t = ini - d;
+        return t < lo ? lo : t;
+    }
+
+private:
+    vector<int64_t> cap;
+    map<Tempo, vector<int64_t>> passos;
+
+    typename map<Tempo, vector<int64_t>>::iterator passo(Tempo t) {
+        auto depois = passos.upper_bound(t), antes = prev(depois);
+        if (antes->first == t) return antes;
+        return passos.emplace_hint(depois, t, antes->second);
+    }
+};
+
+// SGS serial: das atividades com todos os predecessores escalonados entra a de menor
+// prioridade (o LS do CPM: menos folga primeiro; empate pelo índice), no primeiro
+// instante em que os predecessores terminaram e os recursos cabem. Escreve os inícios
+// em S, deixa as reservas em 'perfil' e retorna o fim do projeto. 'uso(v)' devolve o
+// par de ponteiros [a, b) dos usos de v. O grafo precisa ser acíclico.
+template <class Idx, class Tempo, class Adj, class Uso>
+Tempo escalonarSerial(const Grafo<Idx, Adj>& g, Duracoes<Tempo> dur, Faixa<const Tempo> prioridade, Uso&& uso,
+                      PerfilRecursos<Tempo>& perfil, Faixa<Tempo> S) {
+    Idx n = g.qntV;
+    vector<Desl<Idx>> falta(n);
+    priority_queue<pair<Tempo, Idx>, vector<pair<Tempo, Idx>>, greater<>> prontas;
+    for (Idx i = 0; i < n; i++)
+        if ((falta[i] = (Desl<Idx>)g.pred.grau(i)) == 0) prontas.push({prioridade[i], i});
+    Tempo fimProjeto{};
+    while (!prontas.empty()) {
+        Idx u = prontas.top().second;
+        prontas.pop();
+        Tempo t{};
+        g.pred.paraCada(u, [&](Idx p) { t = max(t, S[p] + dur[p]); });
+        auto [a, b] = uso(u);
+        t = perfil.maisCedo(t, dur[u], a, b);
+        perfil.reservar(t, dur[u], a, b, 1);
+        S[u] = t;
+        fimProjeto = max(fimProjeto, t + dur[u]);
+        g.suc.paraCada(u, [&](Idx v) {
+            if (--falta[v] == 0) prontas.push({prioridade[v], v});
+        });
+    }
+    return fimProjeto;
+}
+
+// ---------------- corrente crítica (CCPM) ----------------
+// As durações digitadas são as estimativas agressivas, sem a margem de segurança de
+// cada atividade; a segurança retirada volta agregada em pulmões (Goldratt):
+//   1. o SGS serial nivela o plano pelos recursos (sem --recursos, fica o próprio CPM);
+//   2. a corrente é a cadeia de ligações justas, de precedência ou de recurso, que
+//      termina na atividade que fecha o projeto, refeita de trás para a frente;
+//   3. numa passada em ordem topológica, cada atividade fora da corrente guarda a
+//      cadeia mais longa de atividades fora da corrente que termina nela; onde uma
+//      delas entra na corrente (ou no fim do projeto) há uma cadeia de alimentação;
+//   4. cada cadeia leva um pulmão: corte e cola (metade da soma das durações) ou raiz
+//      da soma dos quadrados (segurança retirada igual à duração agressiva, o corte
+//      usual de 50%). O de projeto, sobre a corrente, vai depois da última atividade;
+//   5. cronograma com pulmões: a corrente fica onde o SGS a pôs; as demais, de trás
+//      para a frente, o mais tarde possível terminando um pulmão antes da entrada na
+//      corrente, dentro dos recursos e nunca antes do início nivelado. Pulmão que não
+//      cabe na folga fica reduzido (efetivo < tamanho), sem empurrar a corrente.
+enum class MetodoPulmao { NENHUM, RAIZ, CORTE };
+
+template <class Tempo>
+Tempo tamanhoPulmao(MetodoPulmao m, double soma, double somaQuadrados) {
+    double x = m == MetodoPulmao::CORTE ? soma / 2 : sqrt(somaQuadrados);
+    if constexpr (is_integral_v<Tempo>) x = ceil(x - 1e-9);   // pulmão em tempo inteiro arredonda para cima
+    return TempoTraits<Tempo>::deReal(x);
+}
+
+template <class Idx, class Tempo>
+struct CorrenteCritica {
+    struct Pulmao {
+        Idx fim;              // última atividade da cadeia de alimentação
+        Idx juncao;           // primeira da corrente que ela alimenta; NENHUM = fim do projeto
+        size_t atividades;    // tamanho da cadeia
+        Tempo tamanho, efetivo;
+    };
+    vector<Idx> corrente;          // em ordem de execução
+    vector<char> porRecurso;       // porRecurso[k]: corrente[k - 1] -> corrente[k] é ligação de recurso
+    vector<char> naCorrente;
+    vector<Pulmao> alimentacao;
+    vector<Tempo> nivelado, inicio;   // SGS serial e cronograma com pulmões
+    Tempo duracaoNivelada{}, pulmaoProjeto{};
+};
+
+template <class Idx, class Tempo, class Adj, class Uso>
+CorrenteCritica<Idx, Tempo> calcularCorrenteCritica(const Grafo<Idx, Adj>& g, Duracoes<Tempo> dur,
+                                                    Faixa<const Tempo> LS, const vector<int64_t>& capacidade,
+                                                    Uso&& uso, MetodoPulmao metodo) {
+    const Idx NENHUM = Grafo<Idx>::NENHUM;
+    Idx n = g.qntV;
+    CorrenteCritica<Idx, Tempo> cc;
+    cc.nivelado.assign(n, Tempo{});
+    PerfilRecursos<Tempo> perfil(capacidade);
+    Faixa<const Tempo> S(cc.nivelado.data(), n);
+    cc.duracaoNivelada = escalonarSerial(g, dur, LS, uso, perfil, Faixa<Tempo>(cc.nivelado));
+    auto fim = [&](Idx i) { return S[i] + dur[i]; };
+    auto igual = [](Tempo a, Tempo b) { return TempoTraits<Tempo>::igual(a, b); };
+
+    // 2. de trás para a frente pelas ligações justas; precedência antes de recurso
+    Idx cur = NENHUM;
+    for (Idx i = 0; i < n; i++)
+        if (igual(fim(i), cc.duracaoNivelada) && (cur == NENHUM || S[i] < S[cur])) cur = i;
+    vector<Idx> porFim;   // índices por fim crescente, só se houver ligação de recurso a procurar
+    auto compartilha = [&](Idx x, Idx y) {
+        auto [a, b] = uso(x);
+        auto [c, d] = uso(y);
+        for (; a != b; a++)
+            for (auto e = c; e != d; e++) if (a->recurso == e->recurso) return true;
+        return false;
+    };
+    vector<char> ligRecurso;
+    while (cur != NENHUM) {
+        cc.corrente.push_back(cur);
+        Idx ant = NENHUM;
+        bool recurso = false;
+        if (Tempo{} < S[cur]) {
+            g.pred.paraCada(cur, [&](Idx p) {
+                if (ant == NENHUM && igual(fim(p), S[cur])) ant = p;
+            });
+            if (ant == NENHUM && Tempo{} < dur[cur]) {
+                if (porFim.empty()) {
+                    porFim.resize(n);
+                    iota(porFim.begin(), porFim.end(), Idx{});
+                    stable_sort(porFim.begin(), porFim.end(), [&](Idx x, Idx y) { return fim(x) < fim(y); });
+                }
+                auto it = lower_bound(porFim.begin(), porFim.end(), S[cur],
+                                      [&](Idx x, Tempo t) { return fim(x) < t && !igual(fim(x), t); });
+                for (; it != porFim.end() && igual(fim(*it), S[cur]) && ant == NENHUM; ++it)
+                    if (Tempo{} < dur[*it] && compartilha(*it, cur)) ant = *it;
+                recurso = ant != NENHUM;
+            }
+        }
+        ligRecurso.push_back(recurso);
+        cur = ant;
+    }
+    reverse(cc.corrente.begin(), cc.corrente.end());
+    cc.porRecurso.assign(cc.corrente.size(), 0);
+    for (size_t k = 1; k < cc.corrente.size(); k++) cc.porRecurso[k] = ligRecurso[cc.corrente.size() - 1 - k];
+    cc.naCorrente.assign(n, 0);
+    double soma = 0, somaQ = 0;
+    for (Idx v : cc.corrente) {
+        double d = TempoTraits<Tempo>::real(dur[v]);
+        cc.naCorrente[v] = 1;
+        soma += d;
+        somaQ += d * d;
+    }
+    cc.pulmaoProjeto = tamanhoPulmao<Tempo>(metodo, soma, somaQ);
+
+    // 3 e 4. cadeia mais longa fora da corrente terminando em cada atividade
+    vector<Idx> ordem(n);
+    vector<Desl<Idx>> indeg(n);
+    topoOrdenacao(g, Faixa<Idx>(ordem), Faixa<Desl<Idx>>(indeg));
+    vector<double> cadeia(n, 0), cadeiaQ(n, 0);
+    vector<size_t> qtd(n, 0);
+    vector<Tempo> pulmao(n, Tempo{});
+    for (Idx u : ordem) {
+        if (cc.naCorrente[u]) continue;
+        Idx melhor = NENHUM;
+        g.pred.paraCada(u, [&](Idx p) {
+            if (!cc.naCorrente[p] && (melhor == NENHUM || cadeia[p] > cadeia[melhor])) melhor = p;
+        });
+        double d = TempoTraits<Tempo>::real(dur[u]);
+        cadeia[u] = d + (melhor == NENHUM ? 0 : cadeia[melhor]);
+        cadeiaQ[u] = d * d + (melhor == NENHUM ? 0 : cadeiaQ[melhor]);
+        qtd[u] = 1 + (melhor == NENHUM ? 0 : qtd[melhor]);
+        Idx juncao = NENHUM;
+        bool temSucessor = false, entra = false;
+        g.suc.paraCada(u, [&](Idx v) {
+            temSucessor = true;
+            if (cc.naCorrente[v] && (!entra || S[v] < S[juncao])) { juncao = v; entra = true; }
+        });
+        if (entra || !temSucessor) {
+            pulmao[u] = tamanhoPulmao<Tempo>(metodo, cadeia[u], cadeiaQ[u]);
+            cc.alimentacao.push_back({u, juncao, qtd[u], pulmao[u], Tempo{}});
+        }
+    }
+
+    // 5. de trás para a frente, o mais tarde que o pulmão, os sucessores e os recursos deixam
+    cc.inicio = cc.nivelado;
+    for (size_t h = n; h-- > 0;) {
+        Idx u = ordem[h];
+        if (cc.naCorrente[u]) continue;
+        Tempo prazo = cc.duracaoNivelada - pulmao[u];
+        g.suc.paraCada(u, [&](Idx v) {
+            prazo = min(prazo, cc.naCorrente[v] ? S[v] - pulmao[u] : cc.inicio[v]);
+        });
+        if (S[u] < prazo - dur[u]) {
+            auto [a, b] = uso(u);
+            perfil.reservar(S[u], dur[u], a, b, -1);
+            cc.inicio[u] = perfil.maisTarde(S[u], prazo - dur[u], dur[u], a, b);
+            perfil.reservar(cc.inicio[u], dur[u], a, b, 1);
+        }
+    }
+    for (auto& p : cc.alimentacao)
+        p.efetivo = (p.juncao == NENHUM ? cc.duracaoNivelada : S[p.juncao]) - (cc.inicio[p.fim] + dur[p.fim]);
+    return cc;
+}
+
+// Cronograma com pulmões em CSV: as atividades e, depois, os pulmões como tarefas
+// (o de alimentação a partir do fim da cadeia, o de projeto depois da corrente).
+// Rótulos sempre por csv(): entre aspas e com aspas dobradas, vírgulas seguras.
+template <class Idx, class Tempo>
+bool gravarCCPM(const string& caminho, const CorrenteCritica<Idx, Tempo>& cc, const Rotulos& rotulos,
+                Duracoes<Tempo> dur) {
+    EscritorBuffer out(caminho);
+    if (!out.aberto()) return false;
+    out << "tipo,rotulo,inicio,fim,nivelado\n";
+    for (size_t i = 0; i < cc.inicio.size(); i++) {
+        out << (cc.naCorrente[i] ? "corrente," : "atividade,") << csv(rotulos[i]) << ',' << cc.inicio[i] << ',' << cc.inicio[i] + dur[i] << ',' << cc.nivelado[i] << '\n';
+    }
+    for (auto& p : cc.alimentacao) {
+        Tempo ini = cc.inicio[p.fim] + dur[p.fim];
+        string nome = string(rotulos[p.fim]) + "->" + (p.juncao == Grafo<Idx>::NENHUM ? "fim" : string(rotulos[p.juncao]));
+        out << "pulmao_alimentacao," << csv(nome) << ',' << ini << ',' << ini + p.tamanho << ",\n";
+    }
+    out << "pulmao_projeto," << csv("projeto") << ',' << cc.duracaoNivelada << ',' << cc.duracaoNivelada + cc.pulmaoProjeto << ",\n";
+    return out.fechar();
+}
+
+// ---------------- multimodo (MRCPSP) ----------------
+// Cada atividade escolhe um modo (duração e recursos: 2 equipes por 5 dias ou 4 por 3)
+// no momento em que é escalonada. Heurística de amostragem em paralelo: cada iteração
+// é um SGS serial com a prioridade (LS do CPM) perturbada, e cada atividade fica com o
+// modo que termina mais cedo no perfil de recursos (às vezes um modo sorteado, para
+// diversificar). Duas podas:
+//   - não renováveis: um modo só é aceito se o consumo dele, somado ao mínimo das
+//     atividades ainda não escalonadas, couber no total; O(não renováveis) por modo;
+//   - limite inferior: calcularPERT com o modo mais curto de cada atividade dá a duração
+//     mínima D e a cauda D - LS de cada uma; a iteração em que início + cauda passa da
+//     melhor duração já achada é abandonada, e achar o próprio D encerra a busca.
+// Cada iteração sorteia com semente própria e a resposta é a de menor duração (no empate,
+// a de menor número): a mesma com qualquer número de threads.
+template <class Tempo>
+struct ResultadoMultimodo {
+    Tempo limiteInferior{}, duracao{};
+    bool viavel = false;            // alguma iteração chegou ao fim
+    int64_t semTotal = -1;          // não renovável cujo consumo mínimo já passa do total
+    size_t executadas = 0, podadas = 0, inviaveis = 0, melhor = 0;
+    vector<uint64_t> modo;          // modo escolhido de cada atividade (índice em plano.modoDur)
+    vector<Tempo> inicio;
+    vector<int64_t> consumo;        // total consumido de cada não renovável
+};
+
+template <class Idx, class Tempo, class Adj>
+ResultadoMultimodo<Tempo> resolverMultimodo(const Grafo<Idx, Adj>& g, const Plano& plano, size_t iteracoes,
+                                            pmr::memory_resource* mem = pmr::get_default_resource()) {
+    Idx n = g.qntV;
+    size_t M = plano.modoDur.size(), R = plano.totalConsumivel.size();
+    ResultadoMultimodo<Tempo> res;
+    vector<Tempo> durModo(M);
+    for (size_t k = 0; k < M; k++) durModo[k] = TempoTraits<Tempo>::deReal((double)plano.modoDur[k]);
+    auto consumos = [&](uint64_t k) {
+        return make_pair(plano.modoConsumos.data() + plano.modoConsumoInicio[k],
+                         plano.modoConsumos.data() + plano.modoConsumoInicio[k + 1]);
+    };
+
+    // modo mais curto e, por não renovável, o consumo do modo mais econômico de cada atividade
+    Vetor<Tempo> durMin(n, Tempo{}, mem), ES(mem), EF(mem), LS(mem), LF(mem);
+    vector<int64_t> minimo(size_t(n) * R), reserva(R, 0), c(R);
+    for (Idx v = 0; v < n; v++) {
+        int64_t* m = &minimo[size_t(v) * R];
+        fill(m, m + R, INT64_MAX);
+        durMin[v] = durModo[plano.modoInicio[v]];
+        for (uint64_t k = plano.modoInicio[v]; k < plano.modoInicio[v + 1]; k++) {
+            durMin[v] = min(durMin[v], durModo[k]);
+            fill(c.begin(), c.end(), 0);
+            for (auto [a, b] = consumos(k); a != b; a++) c[a->recurso] += a->quantidade;
+            for (size_t r = 0; r < R; r++) m[r] = min(m[r], c[r]);
+        }
+        for (size_t r = 0; r < R; r++) reserva[r] += m[r];
+    }
+    calcularPERT(g, Duracoes<Tempo>(durMin), ES, EF, LS, LF, res.limiteInferior);
+    for (size_t r = 0; r < R && res.semTotal < 0; r++)
+        if (reserva[r] > plano.totalConsumivel[r]) res.semTotal = (int64_t)r;
+    if (res.semTotal >= 0) return res;
+
+    vector<Tempo> cauda(n);
+    for (Idx v = 0; v < n; v++) cauda[v] = res.limiteInferior - LS[v];
+    vector<int64_t> cap(plano.capacidade.begin(), plano.capacidade.end());
+    mutex trava;
+    atomic<double> melhorReal{numeric_limits<double>::infinity()};
+    atomic<size_t> proxima{0}, parada{iteracoes}, executadas{0}, podadas{0}, inviaveis{0};
+    double escala = 0.2 * max(1.0, TempoTraits<Tempo>::real(res.limiteInferior));
+
+    size_t nt = max<size_t>(1, min<size_t>(thread::hardware_concurrency(), iteracoes));
+    paraleloBlocos(nt, [&](size_t, size_t, size_t) {
+        vector<Tempo> S(n), F(n);
+        vector<uint64_t> modo(n), viaveis;
+        vector<Desl<Idx>> falta(n);
+        vector<int64_t> consumido(R), resta(R);
+        for (size_t it; (it = proxima++) < iteracoes && it <= parada;) {
+            executadas++;
+            mt19937_64 sorteio(it);
+            uniform_real_distribution<double> u01(0, 1);
+            double ruido = it ? escala : 0;   // a iteração 0 é o SGS puro pelo LS
+            priority_queue<pair<double, Idx>, vector<pair<double, Idx>>, greater<>> prontas;
+            for (Idx v = 0; v < n; v++)
+                if ((falta[v] = (Desl<Idx>)g.pred.grau(v)) == 0)
+                    prontas.push({TempoTraits<Tempo>::real(LS[v]) + ruido * u01(sorteio), v});
+            PerfilRecursos<Tempo> perfil(cap);
+            fill(consumido.begin(), consumido.end(), 0);
+            resta = reserva;
+            Tempo fim{};
+            bool podada = false, inviavel = false;
+            auto passa = [&](Tempo s, Idx v) { return TempoTraits<Tempo>::real(s + cauda[v]) > melhorReal.load(memory_order_relaxed); };
+            while (!prontas.empty() && !podada && !inviavel) {
+                Idx v = prontas.top().second;
+                prontas.pop();
+                Tempo t0{};
+                g.pred.paraCada(v, [&](Idx p) { t0 = max(t0, F[p]); });
+                if (passa(t0, v)) { podada = true; break; }
+                const int64_t* m = &minimo[size_t(v) * R];
+                viaveis.clear();
+                for (uint64_t k = plano.modoInicio[v]; k < plano.modoInicio[v + 1]; k++) {
+                    bool cabe = true;
+                    for (auto [a, b] = consumos(k); a != b && cabe; a++)
+                        cabe = consumido[a->recurso] + a->quantidade + resta[a->recurso] - m[a->recurso] <=
+                               plano.totalConsumivel[a->recurso];
+                    if (cabe) viaveis.push_back(k);
+                }
+                if (viaveis.empty()) { inviavel = true; break; }
+                auto usos = [&](uint64_t k) {
+                    return make_pair(plano.modoUsos.data() + plano.modoUsoInicio[k],
+                                     plano.modoUsos.data() + plano.modoUsoInicio[k + 1]);
+                };
+                uint64_t escolhido = viaveis[0];
+                Tempo s{};
+                if (it && viaveis.size() > 1 && u01(sorteio) < 0.25) {
+                    escolhido = viaveis[sorteio() % viaveis.size()];
+                    auto [a, b] = usos(escolhido);
+                    s = perfil.maisCedo(t0, durModo[escolhido], a, b);
+                } else {
+                    bool primeiro = true;
+                    for (uint64_t k : viaveis) {
+                        auto [a, b] = usos(k);
+                        Tempo sk = perfil.maisCedo(t0, durModo[k], a, b);
+                        if (primeiro || sk + durModo[k] < s + durModo[escolhido]) { escolhido = k; s = sk; }
+                        primeiro = false;
+                    }
+                }
+                if (passa(s, v)) { podada = true; break; }
+                auto [a, b] = usos(escolhido);
+                perfil.reservar(s, durModo[escolhido], a, b, 1);
+                for (auto [x, y] = consumos(escolhido); x != y; x++) consumido[x->recurso] += x->quantidade;
+                for (size_t r = 0; r < R; r++) resta[r] -= m[r];
+                S[v] = s;
+                F[v] = s + durModo[escolhido];
+                modo[v] = escolhido;
+                fim = max(fim, F[v]);
+                g.suc.paraCada(v, [&](Idx w) {
+                    if (--falta[w] == 0) prontas.push({TempoTraits<Tempo>::real(LS[w]) + ruido * u01(sorteio), w});
+                });
+            }
+            if (podada) { podadas++; continue; }
+            if (inviavel) { inviaveis++; continue; }
+            lock_guard<mutex> l(trava);
+            if (!res.viavel || fim < res.duracao || (fim == res.duracao && it < res.melhor)) {
+                res.viavel = true;
+                res.duracao = fim;
+                res.melhor = it;
+                res.modo = modo;
+                res.inicio = S;
+                res.consumo = consumido;
+                melhorReal = TempoTraits<Tempo>::real(fim);
+                if (fim == res.limiteInferior) parada = min(parada.load(), it);
+            }
+        }
+    }, 1);
+    res.executadas = executadas;
+    res.podadas = podadas;
+    res.inviaveis = inviaveis;
+    return res;
+}
+
+// Cronograma multimodo em CSV: modo (1 = primeiro da atividade), duração e datas.
+template <class Tempo>
+bool gravarMultimodo(const string& caminho, const ResultadoMultimodo<Tempo>& mm, const Plano& plano,
+                     const Rotulos& rotulos) {
+    EscritorBuffer out(caminho);
+    if (!out.aberto()) return false;
+    out << "rotulo,modo,duracao,inicio,fim\n";
+    for (size_t v = 0; v < mm.inicio.size(); v++) {
+        uint64_t k = mm.modo[v];
+        Tempo d = TempoTraits<Tempo>::deReal((double)plano.modoDur[k]);
+        out << csv(rotulos[v]) << ',' << k - plano.modoInicio[v] + 1 << ',' << d << ',' << mm.inicio[v] << ','
+            << mm.inicio[v] + d << '\n';
+    }
+    return out.fechar();
+}
+
+// ---------------- importação de builds Ninja ----------------
+// Monta o Plano direto dos arquivos do Ninja, para achar o que limita o tempo de build:
+//   .ninja_log (v5): "início\tfim\tmtime\tsaída\thash", tempos em ms; vale a última
+//     linha de cada saída (o log acumula builds);
+//   ninja -t graph: DOT com um nó por arquivo; passo com uma entrada e uma saída vira
+//     aresta direta, os demais ganham um nó elipse próprio;
+//   ninja -t deps: "alvo: #deps N, ..." seguido das dependências indentadas.
+// Vértices: arquivos, com a duração do passo que os gera (0 para fontes), e passos
+// com nó próprio, com a duração das suas saídas (que ficam com 0). Arestas vão da
+// entrada para a saída. Os arquivos ficam inteiros na memória e os nomes são views
+// sobre eles; os rótulos só são copiados no fim.
+
+// Tabela de hash aberta (sondagem linear) de nomes para valores, para importações
+// com centenas de milhares de caminhos: sem um nó alocado por entrada, a busca
+// costuma custar uma falta de cache em vez de uma por elo da lista do balde. As
+// chaves são views: o texto precisa viver enquanto a tabela for usada.
+class TabelaNomes {
+public:
+    static constexpr uint64_t AUSENTE = UINT64_MAX;
+
+    explicit TabelaNomes(pmr::memory_resource* mem = pmr::get_default_resource()) : slots(mem) {}
+    size_t size() const { return quantidade; }
+    void reserve(size_t n) {
+        size_t cap = 16;
+        while (cap < 2 * n) cap *= 2;
+        if (cap > slots.size()) redimensionar(cap);
+    }
+    // Valor de 'k'; se não existir, insere com 'valor'. 'novo' diz se inseriu.
+    uint64_t inserir(string_view k, uint64_t valor, bool& novo) {
+        return inserir(k, valor, novo, [](string_view x) { return x; });
+    }
+    // Idem, guardando copia(k) como chave quando insere: 'k' pode ser temporária
+    // e a cópia só é feita para chaves novas, com uma sondagem só.
+    template <class Copia>
+    uint64_t inserir(string_view k, uint64_t valor, bool& novo, Copia copia) {
+        if (2 * (quantidade + 1) > slots.size()) redimensionar(max<size_t>(16, 2 * slots.size()));
+        uint64_t h = hash<string_view>()(k);
+        Slot& s = slots[procurar(k, h)];
+        novo = s.valor == AUSENTE;
+        if (novo) {
+            s.chave = copia(k);
+            s.h = h;
+            s.valor = valor;
+            quantidade++;
+        }
+        return s.valor;
+    }
+    void definir(string_view k, uint64_t valor) {
+        bool novo;
+        inserir(k, valor, novo);
+        if (!novo) slots[procurar(k, hash<string_view>()(k))].valor = valor;
+    }
+    uint64_t buscar(string_view k) const {
+        if (slots.empty()) return AUSENTE;
+        return slots[procurar(k, hash<string_view>()(k))].valor;   // slot vazio: AUSENTE
+    }
+
+private:
+    struct Slot {
+        string_view chave;
+        uint64_t h = 0, valor = AUSENTE;
+    };
+    // Posição de 'k' ou do slot vazio onde entraria; não altera a tabela.
+    size_t procurar(string_view k, uint64_t h) const {
+        size_t mascara = slots.size() - 1;
+        for (size_t i = h & mascara;; i = (i + 1) & mascara) {
+            const Slot& s = slots[i];
+            if (s.valor == AUSENTE || (s.h == h && s.chave == k)) return i;
+        }
+    }
+    void redimensionar(size_t cap) {
+        Vetor<Slot> antigos(cap, Slot{}, slots.get_allocator().resource());
+        antigos.swap(slots);
+        for (Slot& s : antigos)
+            if (s.valor != AUSENTE) slots[procurar(s.chave, s.h)] = s;
+    }
+
+    Vetor<Slot> slots;   // potência de 2, no máximo meio cheia
+    size_t quantidade = 0;
+};
+
+struct EstatNinja {
+    size_t arquivos = 0, passos = 0, registrosLog = 0, semDuracao = 0, renomeados = 0;
+    uint64_t arestas = 0;
+};
+
+class ImportadorNinja {
+public:
+    explicit ImportadorNinja(pmr::memory_resource* mem = pmr::get_default_resource())
+        : porCaminho(mem), duracaoLog(mem), nome(mem), passo(mem), produtor(mem), arestas(mem), deps(mem) {}
+
+    bool lerLog(const string& caminhoArq) {
+        string_view txt;
+        if (!carregar(caminhoArq, txt)) return false;
+        duracaoLog.reserve(duracaoLog.size() + count(txt.begin(), txt.end(), '\n'));
+        for (string_view linha; proximaLinha(txt, linha);) {
+            if (linha.empty() || linha[0] == '#') continue;
+            string_view campo[5];
+            size_t n = 0;
+            for (; n < 5 && !linha.empty(); n++) {
+                size_t tab = linha.find('\t');
+                campo[n] = linha.substr(0, tab);
+                linha.remove_prefix(tab == string_view::npos ? linha.size() : tab + 1);
+            }
+            int64_t ini, fim;
+            if (n < 4 || !numero(campo[0], ini) || !numero(campo[1], fim) || fim < ini) continue;
+            duracaoLog.definir(campo[3], (uint64_t)(fim - ini));
+            est.registrosLog++;
+        }
+        return true;
+    }
+
+    bool lerGrafo(const string& caminhoArq) {
+        string_view txt;
+        if (!carregar(caminhoArq, txt)) return false;
+        pmr::memory_resource* mem = nome.get_allocator().resource();
+        TabelaNomes porId(mem);
+        Vetor<pair<string_view, string_view>> ligacoes(mem);
+        // cada nó ocupa uma linha de declaração e ao menos uma de aresta
+        size_t linhas = count(txt.begin(), txt.end(), '\n');
+        porId.reserve(linhas / 2);
+        porCaminho.reserve(porCaminho.size() + linhas / 2);
+        ligacoes.reserve(linhas / 2);
+        for (string_view linha; proximaLinha(txt, linha);) {
+            string_view a, b;
+            if (!aspas(linha, a)) continue;   // cabeçalho e atributos globais
+            while (!linha.empty() && linha[0] == ' ') linha.remove_prefix(1);
+            if (linha.substr(0, 2) == "->") {
+                linha.remove_prefix(2);
+                while (!linha.empty() && linha[0] == ' ') linha.remove_prefix(1);
+                if (aspas(linha, b)) ligacoes.push_back({a, b});
+                continue;
+            }
+            size_t p = linha.find("label=");
+            if (p == string_view::npos) continue;
+            linha.remove_prefix(p + 6);
+            string_view rotulo;
+            if (!aspas(linha, rotulo)) continue;
+            if (linha.find("shape=ellipse") != string_view::npos) {
+                porId.definir(a, nome.size());   // passo: rótulo "regra:saída" montado em concluir()
+                nome.push_back(rotulo);
+                passo.push_back(1);
+                produtor.push_back(NENHUM);
+                est.passos++;
+            } else {
+                porId.definir(a, vertice(rotulo));
+            }
+        }
+        // nós podem ser declarados depois das arestas que os citam
+        for (auto& [x, y] : ligacoes) {
+            uint64_t i = porId.buscar(x), j = porId.buscar(y);
+            if (i == TabelaNomes::AUSENTE || j == TabelaNomes::AUSENTE) continue;
+            arestas.push_back({i, j});
+            if (passo[i] && !passo[j]) produtor[j] = i;
+        }
+        return true;
+    }
+
+    bool lerDeps(const string& caminhoArq) {
+        string_view txt;
+        if (!carregar(caminhoArq, txt)) return false;
+        porCaminho.reserve(porCaminho.size() + count(txt.begin(), txt.end(), '\n') / 4);
+        uint64_t alvo = NENHUM;
+        for (string_view linha; proximaLinha(txt, linha);) {
+            if (linha.empty()) { alvo = NENHUM; continue; }
+            if (linha[0] == ' ' || linha[0] == '\t') {
+                while (!linha.empty() && (linha[0] == ' ' || linha[0] == '\t')) linha.remove_prefix(1);
+                if (alvo != NENHUM && !linha.empty()) deps.push_back({vertice(linha), alvo});
+                continue;
+            }
+            size_t p = linha.rfind(": #deps");
+            alvo = p == string_view::npos ? NENHUM : vertice(linha.substr(0, p));
+        }
+        return true;
+    }
+
+    // Preenche o plano: rótulos, durações do log e predecessores agrupados por destino.
+    void concluir(Plano& plano) {
+        pmr::memory_resource* mem = arestas.get_allocator().resource();
+        uint64_t n = nome.size();
+        // dependência de cabeçalho vale para o passo que gera o alvo, se ele tiver nó próprio
+        for (auto& [de, para] : deps) arestas.push_back({de, produtor[para] != NENHUM ? produtor[para] : para});
+        deps.clear();
+
+        plano.predInicio.assign(n + 1, 0);
+        for (auto& a : arestas) plano.predInicio[a.second + 1]++;
+        for (uint64_t v = 0; v < n; v++) plano.predInicio[v + 1] += plano.predInicio[v];
+        plano.predAlvo.resize(arestas.size());
+        Vetor<uint64_t> pos(plano.predInicio.begin(), plano.predInicio.end() - 1, mem);
+        for (auto& a : arestas) plano.predAlvo[pos[a.second]++] = a.first;
+        est.arestas = arestas.size();
+
+        // passo com nó próprio: a saída mais lenta no log (todas registram o mesmo intervalo)
+        plano.dur.assign(n, 0);
+        Vetor<uint64_t> primeiraSaida(n, NENHUM, mem);
+        Vetor<uint8_t> temDuracao(n, 0, mem);
+        auto doLog = [&](uint64_t arq, uint64_t v) {
+            uint64_t ms = duracaoLog.buscar(nome[arq]);
+            if (ms == TabelaNomes::AUSENTE) return;
+            plano.dur[v] = max<DuracaoEntrada>(plano.dur[v], (DuracaoEntrada)ms);
+            temDuracao[v] = 1;
+        };
+        for (auto& [de, para] : arestas)
+            if (passo[de] && !passo[para]) {
+                if (primeiraSaida[de] == NENHUM) primeiraSaida[de] = para;
+                doLog(para, de);
+            }
+
+        // rótulo do passo: "regra:primeira saída", num texto só reservado de uma vez
+        size_t tamanho = 0;
+        for (uint64_t v = 0; v < n; v++)
+            if (passo[v]) tamanho += nome[v].size() + (primeiraSaida[v] != NENHUM ? 1 + nome[primeiraSaida[v]].size() : 0);
+        textos.push_back(make_unique<string>());
+        string& gerados = *textos.back();
+        gerados.reserve(tamanho);
+        for (uint64_t v = 0; v < n; v++) {
+            if (!passo[v]) continue;
+            size_t ini = gerados.size();
+            gerados.append(nome[v]);
+            if (primeiraSaida[v] != NENHUM) gerados.append(":").append(nome[primeiraSaida[v]]);
+            nome[v] = string_view(gerados).substr(ini);
+        }
+        // Caminhos de arquivo são únicos e ficam como estão; o rótulo do passo pode repetir
+        // um deles ("cc:a.o" é um nome de arquivo válido) ou outro passo (mesma regra, sem
+        // saída): ganha "#2", "#3"... até ficar único.
+        TabelaNomes usados(mem);
+        usados.reserve(n);
+        for (uint64_t v = 0; v < n; v++)
+            if (!passo[v]) usados.definir(nome[v], v);
+        for (uint64_t v = 0; v < n; v++) {
+            if (!passo[v]) continue;
+            bool novo;
+            usados.inserir(nome[v], v, novo);
+            for (uint64_t k = 2; !novo; k++) {
+                string outro = string(nome[v]) + "#" + to_string(k);
+                usados.inserir(outro, v, novo, [&](string_view x) {
+                    textos.push_back(make_unique<string>(x));
+                    return string_view(*textos.back());
+                });
+                if (novo) {
+                    nome[v] = *textos.back();
+                    est.renomeados++;
+                }
+            }
+        }
+
+        for (uint64_t v = 0; v < n; v++) {
+            bool alvo = plano.predInicio[v + 1] > plano.predInicio[v];   // sem predecessor é fonte
+            if (passo[v]) {
+                plano.rotulos.push_back(nome[v]);
+                est.semDuracao += !temDuracao[v];
+                continue;
+            }
+            if (produtor[v] == NENHUM) doLog(v, v);
+            plano.rotulos.push_back(nome[v]);
+            est.arquivos++;
+            est.semDuracao += alvo && produtor[v] == NENHUM && !temDuracao[v];
+        }
+    }
+
+    const EstatNinja& estatisticas() const { return est; }
+
+private:
+    static constexpr uint64_t NENHUM = UINT64_MAX;
+
+    bool carregar(const string& caminhoArq, string_view& txt) {
+        FILE* f = fopen(caminhoArq.c_str(), "rb");
+        if (!f) return false;
+        string dados;
+        char buf[1 << 16];
+        for (size_t k; (k = fread(buf, 1, sizeof(buf), f)) > 0;) dados.append(buf, k);
+        bool ok = !ferror(f);
+        fclose(f);
+        textos.push_back(make_unique<string>(move(dados)));   // views apontam para cá até o fim
+        txt = *textos.back();
+        return ok;
+    }
+    static bool proximaLinha(string_view& txt, string_view& linha) {
+        if (txt.empty()) return false;
+        size_t p = txt.find('\n');
+        linha = txt.substr(0, p);
+        txt.remove_prefix(p == string_view::npos ? txt.size() : p + 1);
+        if (!linha.empty() && linha.back() == '\r') linha.remove_suffix(1);
+        return true;
+    }
+    // "texto" no início de 'linha' (o Ninja não escapa aspas nos caminhos)
+    static bool aspas(string_view& linha, string_view& dentro) {
+        if (linha.empty() || linha[0] != '"') return false;
+        size_t fim = linha.find('"', 1);
+        if (fim == string_view::npos) return false;
+        dentro = linha.substr(1, fim - 1);
+        linha.remove_prefix(fim + 1);
+        return true;
+    }
+    static bool numero(string_view s, int64_t& x) {
+        auto r = from_chars(s.data(), s.data() + s.size(), x);
+        return r.ec == errc() && r.ptr == s.data() + s.size();
+    }
+    uint64_t vertice(string_view caminho) {
+        bool novo;
+        uint64_t v = porCaminho.inserir(caminho, nome.size(), novo);
+        if (novo) {
+            nome.push_back(caminho);
+            passo.push_back(0);
+            produtor.push_back(NENHUM);
+        }
+        return v;
+    }
+
+    vector<unique_ptr<string>> textos;
+    TabelaNomes porCaminho;             // caminho -> vértice
+    TabelaNomes duracaoLog;             // saída -> ms
+    Vetor<string_view> nome;            // caminho do arquivo ou regra do passo
+    Vetor<uint8_t> passo;               // 1 = nó elipse de passo
+    Vetor<uint64_t> produtor;           // passo com nó próprio que gera o arquivo
+    Vetor<pair<uint64_t, uint64_t>> arestas, deps;
+    EstatNinja est;
+};
+
+// ---------------- importação de traces de execução ----------------
+// Reconstrói o DAG executado a partir de tempos reais, para achar o caminho crítico
+// realizado e a folga de cada tarefa com as durações medidas. Formatos:
+//   trace-event JSON do Chrome ({"traceEvents": [...]} ou só o array): fatias "X"
+//     (ts + dur) e pares "B"/"E" por pid/tid; fluxos "s"/"t"/"f" com o mesmo cat/id
+//     ligam a fatia onde o fluxo sai (inteira) à fatia onde ele chega;
+//   log de spans, um objeto por linha: {"id", "name", "start", "end", "deps": [...], "parent"}.
+// "id", "deps" e "parent" valem também dentro de "args". "deps" são predecessores;
+// "parent" só vira aresta se o pai terminou antes de o filho começar (senão é
+// aninhamento). Tempos na unidade do arquivo (µs no Chrome). O arquivo passa pelo
+// LeitorJSON sem ser carregado: a memória cresce com spans e arestas, não com o trace.
+// Os rascunhos que crescem durante a leitura ficam no heap e são devolvidos ao fim
+// (na arena, cada realocação deixaria o buffer antigo para trás); no plano só entra o resultado.
+
+struct EstatTrace {
+    size_t eventos = 0, spans = 0, abertos = 0, depsSemSpan = 0, aninhados = 0;
+    uint64_t arestas = 0, arestasFluxo = 0, contrariadas = 0;
+    double inicio = 0, fim = 0;   // primeiro início e último fim
+};
+
+class ImportadorTrace {
+public:
+    // Rótulos vão direto para o plano; o resto é rascunho do importador.
+    explicit ImportadorTrace(Plano& plano)
+        : plano(plano), mem(pmr::new_delete_resource()), chaves(mem), ids(mem), rotulosVistos(mem), linhas(mem),
+          fluxos(mem), spanDoId(mem), ini(mem), fim(mem), linha(mem), pendentes(mem), pontos(mem), caminho(mem) {}
+
+    bool ler(const string& caminhoArq) {
+        ifstream f(caminhoArq, ios::binary);
+        if (!f) return false;
+        LeitorJSON js(f);
+        for (LeitorJSON::Tipo t; (t = js.proximo()) != LeitorJSON::FIM;) {
+            if (t == LeitorJSON::INICIO_ARR) { if (!lerEventos(js)) return false; }
+            else if (t != LeitorJSON::INICIO_OBJ || !lerObjeto(js, true)) return false;
+        }
+        return true;
+    }
+
+    // Fecha spans sem "E", liga fluxos e dependências e preenche o plano.
+    void concluir() {
+        uint64_t n = ini.size();
+        for (auto& p : pilhas)
+            for (uint64_t s : p) { fim[s] = max(ini[s], ultimoTs); est.abertos++; }
+        pilhas.clear();
+
+        Vetor<pair<uint64_t, uint64_t>> arestas(mem);   // (predecessor, sucessor)
+        resolverFluxos(arestas);
+        for (const Pendente& p : pendentes) {
+            uint64_t de = spanDoId[p.id];
+            if (de == NENHUM) { est.depsSemSpan++; continue; }
+            if (p.pai && fim[de] > ini[p.span]) { est.aninhados++; continue; }
+            if (de != p.span) arestas.push_back({de, p.span});
+        }
+        pendentes = Vetor<Pendente>(mem);
+        // agrupadas por sucessor; repetidas (deps + fluxo, por exemplo) contam uma vez
+        sort(arestas.begin(), arestas.end(), [](auto& a, auto& b) { return tie(a.second, a.first) < tie(b.second, b.first); });
+        arestas.erase(unique(arestas.begin(), arestas.end()), arestas.end());
+
+        plano.predInicio.assign(n + 1, 0);
+        plano.predAlvo.resize(arestas.size());
+        for (size_t k = 0; k < arestas.size(); k++) {
+            plano.predInicio[arestas[k].second + 1]++;
+            plano.predAlvo[k] = arestas[k].first;
+            est.contrariadas += fim[arestas[k].first] > ini[arestas[k].second];
+        }
+        for (uint64_t v = 0; v < n; v++) plano.predInicio[v + 1] += plano.predInicio[v];
+        est.arestas = arestas.size();
+
+        plano.dur.assign(n, 0);
+        est.inicio = n ? ini[0] : 0;
+        est.fim = n ? fim[0] : 0;
+        for (uint64_t s = 0; s < n; s++) {
+            plano.dur[s] = duracao(fim[s] - ini[s]);
+            est.inicio = min(est.inicio, ini[s]);
+            est.fim = max(est.fim, fim[s]);
+        }
+        caminhoRealizado();
+    }
+
+    const EstatTrace& estatisticas() const { return est; }
+    // Do primeiro ao último span do caminho realizado.
+    const Vetor<uint64_t>& realizado() const { return caminho; }
+    double execucaoRealizada() const { return execucao; }
+    double esperaRealizada() const { return espera; }
+
+    static DuracaoEntrada duracao(double x) {
+        if constexpr (is_integral_v<DuracaoEntrada>) return (DuracaoEntrada)llround(x);
+        else return (DuracaoEntrada)x;
+    }
+
+private:
+    static constexpr uint64_t NENHUM = UINT64_MAX;
+
+    // Campos do evento corrente; as strings são reaproveitadas de um evento para o outro.
+    struct Evento {
+        string ph, nome, id, idArgs, pai, pid, tid, cat, bp;
+        vector<string> deps;
+        size_t nDeps = 0;
+        double ts = 0, dur = 0, inicio = 0, fim = 0;
+        bool temTs = false, temDur = false, temInicio = false, temFim = false;
+
+        void limpar() {
+            for (string* s : {&ph, &nome, &id, &idArgs, &pai, &pid, &tid, &cat, &bp}) s->clear();
+            nDeps = 0;
+            temTs = temDur = temInicio = temFim = false;
+        }
+    };
+    struct Pendente {
+        uint64_t id, span;   // span depende do span com esse id
+        bool pai;
+    };
+    struct PontoFluxo {
+        uint64_t fluxo, span;
+        double ts;
+        uint32_t linha;
+        char fase;           // 's', 't' ou 'f'
+        bool dentro;         // "bp": "e": chegada presa à fatia que contém o ponto
+    };
+
+    bool lerEventos(LeitorJSON& js) {
+        LeitorJSON::Tipo t;
+        while ((t = js.proximo()) == LeitorJSON::INICIO_OBJ)
+            if (!lerObjeto(js, false)) return false;
+        return t == LeitorJSON::FIM_ARR;
+    }
+    bool lerObjeto(LeitorJSON& js, bool topo) {
+        ev.limpar();
+        bool container = false;
+        if (!lerCampos(js, topo, false, container)) return false;
+        if (!container) registrar();
+        return true;
+    }
+    // Campos até o '}' do objeto aberto; de "args" só interessam id, deps e parent.
+    bool lerCampos(LeitorJSON& js, bool topo, bool emArgs, bool& container) {
+        LeitorJSON::Tipo t;
+        while ((t = js.proximo()) == LeitorJSON::CHAVE) {
+            chave = js.texto();
+            t = js.proximo();
+            if (t == LeitorJSON::INICIO_ARR && topo && chave == "traceEvents") {
+                container = true;
+                if (!lerEventos(js)) return false;
+            } else if (t == LeitorJSON::INICIO_ARR && chave == "deps") {
+                while ((t = js.proximo()) == LeitorJSON::TEXTO || t == LeitorJSON::NUMERO) {
+                    if (ev.nDeps == ev.deps.size()) ev.deps.emplace_back();
+                    ev.deps[ev.nDeps++] = js.texto();
+                }
+                if (t != LeitorJSON::FIM_ARR) return false;
+            } else if (t == LeitorJSON::INICIO_OBJ && !emArgs && chave == "args") {
+                if (!lerCampos(js, false, true, container)) return false;
+            } else if (t == LeitorJSON::TEXTO || t == LeitorJSON::NUMERO) {
+                campo(js, emArgs);
+            } else if (t == LeitorJSON::INICIO_OBJ || t == LeitorJSON::INICIO_ARR) {
+                js.pular();
+            } else if (t != LeitorJSON::LITERAL) {
+                return false;
+            }
+        }
+        return t == LeitorJSON::FIM_OBJ;
+    }
+    // Um campo por token de um trace de GB: separa pelo tamanho da chave antes de comparar.
+    void campo(LeitorJSON& js, bool emArgs) {
+        const string& v = js.texto();
+        string_view c = chave;
+        switch (c.size()) {
+            case 2:
+                if (c == "id") (emArgs ? ev.idArgs : ev.id) = v;
+                else if (emArgs) return;
+                else if (c == "ph") ev.ph = v;
+                else if (c == "ts") { ev.ts = js.real(); ev.temTs = true; }
+                else if (c == "bp") ev.bp = v;
+                break;
+            case 3:
+                if (emArgs) return;
+                if (c == "pid") ev.pid = v;
+                else if (c == "tid") ev.tid = v;
+                else if (c == "dur") { ev.dur = js.real(); ev.temDur = true; }
+                else if (c == "cat") ev.cat = v;
+                else if (c == "end") { ev.fim = js.real(); ev.temFim = true; }
+                break;
+            case 4:
+                if (!emArgs && c == "name") ev.nome = v;
+                break;
+            case 5:
+                if (!emArgs && c == "start") { ev.inicio = js.real(); ev.temInicio = true; }
+                break;
+            case 6:
+                if (c == "parent") ev.pai = v;
+                break;
+        }
+    }
+
+    void registrar() {
+        est.eventos++;
+        char ph = ev.ph.size() == 1 ? ev.ph[0] : ev.ph.empty() ? 'X' : '?';
+        if (ph == 'X') {
+            if (ev.temInicio && ev.temFim) novoSpan(ev.inicio, ev.fim);
+            else if (ev.temTs && ev.temDur) novoSpan(ev.ts, ev.ts + ev.dur);
+        } else if (!ev.temTs) {
+            return;
+        } else if (ph == 'B') {
+            uint64_t s = novoSpan(ev.ts, ev.ts);
+            pilhas[linha[s]].push_back(s);
+        } else if (ph == 'E') {
+            vector<uint64_t>& p = pilhas[linhaDoEvento()];
+            ultimoTs = max(ultimoTs, ev.ts);
+            if (p.empty()) return;
+            fim[p.back()] = max(ini[p.back()], ev.ts);
+            p.pop_back();
+        } else if ((ph == 's' || ph == 't' || ph == 'f') && !ev.id.empty()) {
+            tmp.assign(ev.cat).append(1, '\x1f').append(ev.id);   // ids de fluxo valem por categoria
+            pontos.push_back({interno(fluxos, tmp, nullptr), NENHUM, ev.ts, linhaDoEvento(), ph, ev.bp == "e"});
+        }
+    }
+
+    uint64_t novoSpan(double a, double b) {
+        uint64_t s = ini.size();
+        ini.push_back(a);
+        fim.push_back(max(a, b));
+        linha.push_back(linhaDoEvento());
+        ultimoTs = max(ultimoTs, fim[s]);
+        est.spans++;
+
+        const string& id = !ev.idArgs.empty() ? ev.idArgs : ev.id;
+        rotular(!ev.nome.empty() ? string_view(ev.nome) : !id.empty() ? string_view(id) : string_view("span"));
+        if (!id.empty()) {
+            uint64_t k = idDoTexto(id);
+            if (spanDoId[k] == NENHUM) spanDoId[k] = s;   // id repetido fica com o primeiro span
+        }
+        for (size_t k = 0; k < ev.nDeps; k++) pendentes.push_back({idDoTexto(ev.deps[k]), s, false});
+        if (!ev.pai.empty()) pendentes.push_back({idDoTexto(ev.pai), s, true});
+        return s;
+    }
+    // Nome repetido ganha "#k" (k-ésima ocorrência), para a tabela e o caminho não ficarem ambíguos.
+    void rotular(string_view base) {
+        bool novo;
+        uint64_t k = rotulosVistos.inserir(base, 1, novo, [&](string_view x) { return copiar(x); });
+        if (novo) {
+            plano.rotulos.push_back(base);
+            return;
+        }
+        rotulosVistos.definir(base, k + 1);
+        char num[24];
+        tmp.assign(base).append(1, '#').append(num, to_chars(num, num + sizeof(num), k + 1).ptr);
+        plano.rotulos.push_back(tmp);
+    }
+    uint64_t idDoTexto(string_view id) {
+        bool novo;
+        uint64_t k = interno(ids, id, &novo);
+        if (novo) spanDoId.push_back(NENHUM);
+        return k;
+    }
+    uint32_t linhaDoEvento() {
+        tmp.assign(ev.pid).append(1, '\x1f').append(ev.tid);
+        bool novo;
+        uint64_t k = interno(linhas, tmp, &novo);
+        if (novo) pilhas.emplace_back();
+        return (uint32_t)k;
+    }
+    // Índice sequencial da chave na tabela; a chave é copiada só na primeira vez.
+    uint64_t interno(TabelaNomes& tab, string_view k, bool* novo) {
+        bool inseriu;
+        uint64_t v = tab.inserir(k, tab.size(), inseriu, [&](string_view x) { return copiar(x); });
+        if (novo) *novo = inseriu;
+        return v;
+    }
+    string_view copiar(string_view s) {
+        char* p = (char*)chaves.allocate(max<size_t>(s.size(), 1), 1);
+        memcpy(p, s.data(), s.size());
+        return string_view(p, s.size());
+    }
+
+    // Cada ponto de fluxo fica com a fatia mais interna do seu pid/tid que o contém;
+    // a chegada sem "bp": "e" fica com a próxima fatia que começa ali ou depois, como
+    // no visualizador do Chrome. Pontos consecutivos do mesmo fluxo viram arestas.
+    void resolverFluxos(Vetor<pair<uint64_t, uint64_t>>& arestas) {
+        if (pontos.empty()) return;
+        uint64_t n = ini.size();
+        Vetor<uint64_t> ordem(n, 0, mem);
+        for (uint64_t s = 0; s < n; s++) ordem[s] = s;
+        // por linha e início; a mais longa primeiro, para a externa entrar antes na pilha
+        sort(ordem.begin(), ordem.end(), [&](uint64_t a, uint64_t b) {
+            if (linha[a] != linha[b]) return linha[a] < linha[b];
+            if (ini[a] != ini[b]) return ini[a] < ini[b];
+            return fim[a] > fim[b];
+        });
+        sort(pontos.begin(), pontos.end(), [](const PontoFluxo& a, const PontoFluxo& b) {
+            return tie(a.linha, a.ts) < tie(b.linha, b.ts);
+        });
+        Vetor<uint64_t> pilha(mem);
+        size_t k = 0;
+        for (size_t i = 0; i < pontos.size();) {
+            uint32_t l = pontos[i].linha;
+            while (k < n && linha[ordem[k]] < l) k++;
+            pilha.clear();
+            for (; i < pontos.size() && pontos[i].linha == l; i++) {
+                PontoFluxo& p = pontos[i];
+                for (; k < n && linha[ordem[k]] == l && ini[ordem[k]] <= p.ts; k++) {
+                    while (!pilha.empty() && fim[pilha.back()] <= ini[ordem[k]]) pilha.pop_back();
+                    pilha.push_back(ordem[k]);
+                }
+                while (!pilha.empty() && fim[pilha.back()] < p.ts) pilha.pop_back();
+                uint64_t dentro = pilha.empty() ? NENHUM : pilha.back();
+                bool comecaAqui = dentro != NENHUM && ini[dentro] == p.ts;
+                if (p.fase == 'f' && !p.dentro && !comecaAqui && k < n && linha[ordem[k]] == l) p.span = ordem[k];
+                else p.span = dentro;
+            }
+        }
+        // fases de mesmo instante na ordem s, t, f
+        sort(pontos.begin(), pontos.end(), [](const PontoFluxo& a, const PontoFluxo& b) {
+            auto fase = [](char c) { return c == 's' ? 0 : c == 't' ? 1 : 2; };
+            return make_tuple(a.fluxo, a.ts, fase(a.fase)) < make_tuple(b.fluxo, b.ts, fase(b.fase));
+        });
+        for (size_t i = 1; i < pontos.size(); i++) {
+            const PontoFluxo& a = pontos[i - 1];
+            const PontoFluxo& b = pontos[i];
+            if (a.fluxo != b.fluxo || b.fase == 's' || a.span == NENHUM || b.span == NENHUM || a.span == b.span)
+                continue;
+            arestas.push_back({a.span, b.span});
+            est.arestasFluxo++;
+        }
+        pontos = Vetor<PontoFluxo>(mem);
+    }
+
+    // A partir do span que terminou por último, volta sempre pelo predecessor que
+    // terminou por último: a cadeia que de fato segurou o fim do trace. A espera soma
+    // os intervalos entre o fim de um e o início do seguinte e o atraso do primeiro.
+    void caminhoRealizado() {
+        uint64_t n = ini.size();
+        if (n == 0) return;
+        uint64_t cur = 0;
+        for (uint64_t s = 1; s < n; s++) if (fim[s] > fim[cur]) cur = s;
+        Vetor<uint8_t> visto(n, 0, mem);   // dependências contrariadas podem fechar ciclo
+        while (cur != NENHUM && !visto[cur]) {
+            visto[cur] = 1;
+            caminho.push_back(cur);
+            execucao += fim[cur] - ini[cur];
+            uint64_t ant = NENHUM;
+            for (uint64_t k = plano.predInicio[cur]; k < plano.predInicio[cur + 1]; k++) {
+                uint64_t p = plano.predAlvo[k];
+                if (ant == NENHUM || fim[p] > fim[ant]) ant = p;
+            }
+            espera += max(0.0, ini[cur] - (ant == NENHUM ? est.inicio : fim[ant]));
+            cur = ant;
+        }
+        reverse(caminho.begin(), caminho.end());
+    }
+
+    Plano& plano;
+    pmr::memory_resource* mem;
+    pmr::monotonic_buffer_resource chaves;   // textos das chaves das tabelas abaixo
+    Evento ev;
+    string chave, tmp;
+    TabelaNomes ids, rotulosVistos, linhas, fluxos;   // id -> índice em spanDoId; rótulo -> ocorrências; pid/tid; cat/id
+    Vetor<uint64_t> spanDoId;
+    Vetor<double> ini, fim;
+    Vetor<uint32_t> linha;                // pid/tid de cada span
+    vector<vector<uint64_t>> pilhas;      // "B" ainda sem "E", por pid/tid
+    Vetor<Pendente> pendentes;
+    Vetor<PontoFluxo> pontos;
+    double ultimoTs = 0;
+    EstatTrace est;
+    Vetor<uint64_t> caminho;
+    double execucao = 0, espera = 0;
+};
+
+// ---------------- ordem topológica dinâmica (Pearce-Kelly) ----------------
+// Posição de cada vértice numa ordem topológica de um grafo que ganha arestas aos
+// poucos. Se u -> v viola a ordem, só os alcançáveis de v antes de u e os que
+// alcançam u depois de v trocam de posição entre si; aresta que fecharia ciclo é
+// recusada. Remover arestas nunca invalida a ordem. Vértices são slots 0..n-1.
+class OrdemDinamica {
+public:
+    uint64_t operator[](uint32_t v) const { return pos[v]; }
+
+    // v vai para depois de todos: sem arestas, qualquer posição nova serve.
+    void novo(uint32_t v) {
+        if (v >= pos.size()) {
+            pos.resize(v + 1);
+            marca.resize(v + 1);
+        }
+        pos[v] = prox++;
+    }
+    void limpar() {
+        pos.clear();
+        marca.clear();
+        prox = 0;
+    }
+
+    // Reordena para a aresta u -> v, ainda fora das listas; 'suc(x)' e 'pred(x)'
+    // dão as listas atuais de x. Retorna false se v alcança u.
+    template <class Suc, class Pred>
+    bool inserir(uint32_t u, uint32_t v, Suc&& suc, Pred&& pred) {
+        uint64_t lb = pos[v], ub = pos[u];
+        if (lb > ub) return true;
+        frente.clear();
+        tras.clear();
+        bool ciclo = false;
+        auto dfs = [&](uint32_t ini, bool paraFrente, vector<uint32_t>& visitados) {
+            pilha.assign(1, ini);
+            marca[ini] = true;
+            while (!pilha.empty() && !ciclo) {
+                uint32_t x = pilha.back();
+                pilha.pop_back();
+                visitados.push_back(x);
+                for (uint32_t w : paraFrente ? suc(x) : pred(x)) {
+                    if (paraFrente && w == u) { ciclo = true; break; }
+                    bool dentro = paraFrente ? pos[w] < ub : pos[w] > lb;
+                    if (dentro && !marca[w]) { marca[w] = true; pilha.push_back(w); }
+                }
+            }
+            for (uint32_t x : pilha) visitados.push_back(x);   // marcados e ainda não visitados
+        };
+        dfs(v, true, frente);
+        if (!ciclo) dfs(u, false, tras);
+        for (uint32_t x : frente) marca[x] = false;
+        for (uint32_t x : tras) marca[x] = false;
+        if (ciclo) return false;
+        auto porOrdem = [&](uint32_t a, uint32_t b) { return pos[a] < pos[b]; };
+        sort(frente.begin(), frente.end(), porOrdem);
+        sort(tras.begin(), tras.end(), porOrdem);
+        posicoes.clear();
+        for (uint32_t x : tras) posicoes.push_back(pos[x]);
+        for (uint32_t x : frente) posicoes.push_back(pos[x]);
+        sort(posicoes.begin(), posicoes.end());
+        size_t k = 0;
+        for (uint32_t x : tras) pos[x] = posicoes[k++];
+        for (uint32_t x : frente) pos[x] = posicoes[k++];
+        return true;
+    }
+
+private:
+    vector<uint64_t> pos;
+    vector<uint8_t> marca;
+    uint64_t prox = 0;
+    vector<uint32_t> frente, tras, pilha;   // rascunhos reaproveitados
+    vector<uint64_t> posicoes;
+};
+
+// ---------------- modo online (DAGs chegando em fluxo) ----------------
+// Para um fluxo contínuo de DAGs pequenos (pipelines de CI): atividades, arestas e
+// inícios/fins reais chegam um evento por linha e ES/EF são atualizados só a partir
+// do que mudou. A ordem topológica é mantida a cada aresta (Pearce-Kelly): a
+// propagação visita cada afetado uma vez, em ordem, e aresta que fecharia ciclo é
+// recusada. ES = início real, se houver; senão o maior EF dos predecessores, nunca
+// antes da chegada da atividade. EF = fim real, se houver; senão ES + duração.
+// Cada componente conexo é um DAG. Concluído (todas as atividades com fim real) há
+// mais que a janela, contando do maior tempo real visto, ele sai da memória: os slots
+// vão para uma lista livre e a memória fica no tamanho do pico de DAGs ativos.
+//
+// Eventos, um por linha ('#' comenta):
+//   atividade ROTULO DURACAO   aresta DE PARA   inicio ROTULO T   fim ROTULO T
+//   caminho ROTULO             estado
+class EscalonadorOnline {
+public:
+    using Tempo = DuracaoEntrada;
+
+    explicit EscalonadorOnline(Tempo janela) : janela(janela) {}
+
+    // Aplica um evento; comandos inválidos viram aviso em cerr e o fluxo continua.
+    void processar(string_view linha, size_t numLinha) {
+        separarCampos(linha, campo);
+        size_t n = campo.size();
+        if (n == 0) return;
+        string_view cmd = campo[0];
+        Tempo t{};
+        uint32_t a, b;
+        const char* erro = nullptr;
+        if (cmd == "atividade" && n == 3 && lerNumero(campo[2], t)) erro = novaAtividade(campo[1], t);
+        else if (cmd == "aresta" && n == 3) erro = !achar(campo[1], a) || !achar(campo[2], b) ? "rótulo inexistente" : novaAresta(a, b);
+        else if ((cmd == "inicio" || cmd == "fim") && n == 3 && lerNumero(campo[2], t))
+            erro = !achar(campo[1], a) ? "rótulo inexistente" : cmd == "inicio" ? iniciar(a, t) : terminar(a, t);
+        else if (cmd == "caminho" && n == 2) erro = !achar(campo[1], a) ? "rótulo inexistente" : (consultar(a), nullptr);
+        else if (cmd == "estado" && n == 1) imprimirEstado();
+        else erro = "comando inválido";
+        if (erro) cerr << "Aviso: linha " << numLinha << ": " << erro << ": " << linha << "\n";
+        expirar();
+    }
+
+    void imprimirEstado() const {
+        cout << "Estado: " << ativas << " atividade(s) em " << dagsAtivos << " DAG(s) ativo(s); " << dagsDescartados
+             << " DAG(s) descartado(s) (" << descartadas << " atividade(s)); " << nos.size() << " slot(s)\n";
+    }
+
+private:
+    static constexpr uint32_t NENHUM = UINT32_MAX;
+
+    struct No {
+        string rotulo;
+        vector<uint32_t> suc, pred;          // esvaziados e reaproveitados quando o slot volta
+        Tempo dur{}, chegada{}, ES{}, EF{}, inicioReal{}, fimReal{};
+        bool iniciou = false, terminou = false, livre = false, naFila = false;
+        uint32_t pai = 0, proxMembro = NENHUM;   // union-find do DAG; lista dos membros
+        // válidos na raiz do DAG
+        uint32_t primeiro = 0, ultimo = 0, total = 0, concluidas = 0;
+        Tempo fimDag{};
+        uint64_t selo = 0;                   // muda a cada alteração do DAG; invalida descartes agendados
+    };
+
+    Tempo janela, agora{};
+    vector<No> nos;
+    vector<uint32_t> livres;
+    unordered_map<string, uint32_t> porRotulo;
+    OrdemDinamica ordem;
+    uint64_t proxSelo = 0;
+    size_t ativas = 0, dagsAtivos = 0, dagsDescartados = 0, descartadas = 0;
+    // (fim do DAG, raiz, selo): o mais antigo primeiro
+    priority_queue<tuple<Tempo, uint32_t, uint64_t>, vector<tuple<Tempo, uint32_t, uint64_t>>, greater<>> descartes;
+    vector<uint32_t> pilha;                  // rascunho reaproveitado
+    vector<string_view> campo;
+    priority_queue<pair<uint64_t, uint32_t>, vector<pair<uint64_t, uint32_t>>, greater<>> fila;
+
+    bool achar(string_view rot, uint32_t& v) {
+        auto it = porRotulo.find(string(rot));
+        if (it == porRotulo.end()) return false;
+        v = it->second;
+        return true;
+    }
+    uint32_t raiz(uint32_t v) {
+        while (nos[v].pai != v) v = nos[v].pai = nos[nos[v].pai].pai;   // meia compressão
+        return v;
+    }
+
+    const char* novaAtividade(string_view rot, Tempo dur) {
+        if (porRotulo.count(string(rot))) return "rótulo já existe";
+        uint32_t v;
+        if (!livres.empty()) { v = livres.back(); livres.pop_back(); }
+        else { v = (uint32_t)nos.size(); nos.emplace_back(); }
+        No& x = nos[v];
+        x.rotulo.assign(rot);
+        x.dur = dur;
+        x.chegada = x.ES = agora;
+        x.EF = agora + dur;
+        x.iniciou = x.terminou = x.livre = false;
+        ordem.novo(v);
+        x.pai = x.primeiro = x.ultimo = v;
+        x.proxMembro = NENHUM;
+        x.total = 1;
+        x.concluidas = 0;
+        x.fimDag = Tempo{};
+        x.selo = proxSelo++;
+        porRotulo.emplace(x.rotulo, v);
+        ativas++;
+        dagsAtivos++;
+        return nullptr;
+    }
+
+    const char* novaAresta(uint32_t u, uint32_t v) {
+        if (u == v) return "aresta de uma atividade para ela mesma";
+        if (find(nos[u].suc.begin(), nos[u].suc.end(), v) != nos[u].suc.end()) return nullptr;
+        if (!ordem.inserir(u, v, [&](uint32_t x) -> const vector<uint32_t>& { return nos[x].suc; },
+                           [&](uint32_t x) -> const vector<uint32_t>& { return nos[x].pred; }))
+            return "aresta fecharia ciclo";
+        nos[u].suc.push_back(v);
+        nos[v].pred.push_back(u);
+        unir(u, v);
+        propagar(v);
+        return nullptr;
+    }
+
+    // Recalcula v e, em ordem topológica, os sucessores cujo EF mudou.
+    void propagar(uint32_t v) {
+        fila.push({ordem[v], v});
+        nos[v].naFila = true;
+        while (!fila.empty()) {
+            uint32_t x = fila.top().second;
+            fila.pop();
+            No& n = nos[x];
+            n.naFila = false;
+            Tempo es = n.iniciou ? n.inicioReal : n.chegada;
+            if (!n.iniciou) for (uint32_t p : n.pred) es = max(es, nos[p].EF);
+            Tempo ef = n.terminou ? n.fimReal : es + n.dur;
+            bool mudou = ef != n.EF;
+            n.ES = es;
+            n.EF = ef;
+            if (mudou || x == v)
+                for (uint32_t w : n.suc)
+                    if (!nos[w].naFila) { nos[w].naFila = true; fila.push({ordem[w], w}); }
+        }
+    }
+
+    void unir(uint32_t a, uint32_t b) {
+        a = raiz(a);
+        b = raiz(b);
+        if (a == b) return;
+        if (nos[a].total < nos[b].total) swap(a, b);
+        No &ra = nos[a], &rb = nos[b];
+        rb.pai = a;
+        nos[ra.ultimo].proxMembro = rb.primeiro;
+        ra.ultimo = rb.ultimo;
+        ra.total += rb.total;
+        ra.concluidas += rb.concluidas;
+        ra.fimDag = max(ra.fimDag, rb.fimDag);
+        ra.selo = proxSelo++;
+        dagsAtivos--;
+        if (ra.concluidas == ra.total) descartes.push({ra.fimDag, a, ra.selo});   // dois DAGs já concluídos
+    }
+
+    const char* iniciar(uint32_t v, Tempo t) {
+        No& x = nos[v];
+        if (x.terminou) return "atividade já terminou";
+        x.iniciou = true;
+        x.inicioReal = t;
+        agora = max(agora, t);
+        propagar(v);
+        return nullptr;
+    }
+
+    const char* terminar(uint32_t v, Tempo t) {
+        No& x = nos[v];
+        if (x.terminou) return "atividade já terminou";
+        if (!x.iniciou || x.inicioReal > t) {   // sem "inicio": começou no ES previsto (ou no fim)
+            x.iniciou = true;
+            x.inicioReal = min(x.ES, t);
+        }
+        x.terminou = true;
+        x.fimReal = t;
+        agora = max(agora, t);
+        propagar(v);
+        uint32_t r = raiz(v);
+        No& d = nos[r];
+        d.concluidas++;
+        d.fimDag = max(d.fimDag, t);
+        d.selo = proxSelo++;
+        if (d.concluidas == d.total) {
+            cout << "Concluído: ";
+            imprimirDag(r);
+            descartes.push({d.fimDag, r, d.selo});
+        }
+        return nullptr;
+    }
+
+    // DAGs concluídos antes de agora - janela, e que não mudaram desde então, saem.
+    void expirar() {
+        while (!descartes.empty() && get<0>(descartes.top()) + janela < agora) {
+            auto [fimDag, r, selo] = descartes.top();
+            descartes.pop();
+            (void)fimDag;
+            if (nos[r].livre || nos[r].pai != r || nos[r].selo != selo) continue;
+            for (uint32_t x = nos[r].primeiro; x != NENHUM;) {
+                No& n = nos[x];
+                uint32_t prox = n.proxMembro;
+                porRotulo.erase(n.rotulo);
+                n.suc.clear();
+                n.pred.clear();
+                n.livre = true;
+                livres.push_back(x);
+                ativas--;
+                descartadas++;
+                x = prox;
+            }
+            dagsAtivos--;
+            dagsDescartados++;
+        }
+    }
+
+    // Termina no membro de maior EF e volta pelo predecessor cujo EF é o ES do atual.
+    void caminhoDag(uint32_t r, vector<uint32_t>& cam) const {
+        uint32_t cur = r;
+        for (uint32_t x = nos[r].primeiro; x != NENHUM; x = nos[x].proxMembro)
+            if (nos[x].EF > nos[cur].EF) cur = x;
+        cam.clear();
+        while (cur != NENHUM) {
+            cam.push_back(cur);
+            uint32_t ant = NENHUM;
+            for (uint32_t p : nos[cur].pred) if (TempoTraits<Tempo>::igual(nos[p].EF, nos[cur].ES)) { ant = p; break; }
+            cur = ant;
+        }
+        reverse(cam.begin(), cam.end());
+    }
+    void imprimirDag(uint32_t r) {
+        Tempo ini = nos[r].ES, fimPrev = nos[r].EF;
+        for (uint32_t x = nos[r].primeiro; x != NENHUM; x = nos[x].proxMembro) {
+            ini = min(ini, nos[x].ES);
+            fimPrev = max(fimPrev, nos[x].EF);
+        }
+        vector<uint32_t>& cam = pilha;
+        caminhoDag(r, cam);
+        cout << "DAG '" << nos[nos[r].primeiro].rotulo << "': " << nos[r].total << " atividade(s), "
+             << nos[r].concluidas << " concluída(s), de " << ini << " a " << fimPrev << " (duração "
+             << fimPrev - ini << "); caminho crítico: ";
+        for (size_t i = 0; i < cam.size(); i++) cout << (i ? " -> " : "") << nos[cam[i]].rotulo;
+        cout << "\n";
+    }
+    void consultar(uint32_t v) {
+        const No& x = nos[v];
+        cout << x.rotulo << ": ES " << x.ES << ", EF " << x.EF
+             << (x.terminou ? " (concluída)" : x.iniciou ? " (em andamento)" : " (prevista)") << "; ";
+        imprimirDag(raiz(v));
+    }
+};
+
+// Lê eventos de 'in' até o fim, com ES/EF e caminhos críticos atualizados a cada um.
+int executarOnline(istream& in, DuracaoEntrada janela) {
+    cout << "=== PERT/CPM (modo online) ===\n\n";
+    EscalonadorOnline esc(janela);
+    string linha;
+    for (size_t num = 1; getline(in, linha); num++) esc.processar(linha, num);
+    esc.imprimirEstado();
+    return 0;
+}
+
+// ---------------- progresso (atualização de status) ----------------
+// Uma linha por atividade iniciada ('#' comenta):
+//   ROTULO concluida INICIO FIM
+//   ROTULO andamento INICIO RESTANTE     (duração que ainda falta)
+//   ROTULO andamento INICIO P%           (P% feito: falta (100 - P)% da duração planejada)
+// As demais não começaram; com 'temStatus', datas reais não passam de 'status' (sem
+// ela, a data de status é a maior data lida). Em caso de falha, o motivo fica em
+// 'erro'. Chamar antes de compactar os rótulos.
+bool lerProgresso(const string& arq, bool temStatus, DuracaoEntrada status, Plano& plano, string& erro) {
+    ifstream f(arq);
+    if (!f) {
+        erro = "não foi possível abrir " + arq;
+        return false;
+    }
+    size_t n = plano.qntV();
+    plano.situacao.assign(n, 0);
+    plano.inicioReal.assign(n, 0);
+    plano.fimReal.assign(n, 0);
+    plano.restante.assign(n, 0);
+    IndiceRotulos indice(plano.rotulos);
+    DuracaoEntrada maiorData = 0;
+    string linha;
+    vector<string_view> campo;
+    for (size_t num = 1; getline(f, linha); num++) {
+        separarCampos(linha, campo);
+        size_t k = campo.size();
+        if (k == 0) continue;
+        auto falha = [&](const char* msg) {
+            erro = arq + ":" + to_string(num) + ": " + msg;
+            return false;
+        };
+        if (k != 4) return falha("esperado 'ROTULO concluida|andamento INICIO FIM|RESTANTE|P%'");
+        int64_t i = indice.buscar(campo[0]);
+        DuracaoEntrada ini, x;
+        if (i < 0) return falha("rótulo inexistente");
+        if (!lerNumero(campo[2], ini)) return falha("início inválido");
+        if (temStatus && ini > status) return falha("início real depois da data de status");
+        if (campo[1] == "concluida") {
+            if (!lerNumero(campo[3], x) || x < ini) return falha("fim inválido");
+            if (temStatus && x > status) return falha("fim real depois da data de status");
+            plano.situacao[i] = 2;
+            plano.fimReal[i] = x;
+            maiorData = max(maiorData, x);
+        } else if (campo[1] == "andamento") {
+            string_view r = campo[3];
+            bool pct = !r.empty() && r.back() == '%';
+            if (pct) r.remove_suffix(1);
+            if (!lerNumero(r, x) || (pct && x > 100)) return falha("restante inválido");
+            if (pct) x = TempoTraits<DuracaoEntrada>::deReal((double)plano.dur[i] * (double)(100 - x) / 100.0);
+            plano.situacao[i] = 1;
+            plano.restante[i] = x;
+        } else {
+            return falha("situação deve ser 'concluida' ou 'andamento'");
+        }
+        plano.inicioReal[i] = ini;
+        maiorData = max(maiorData, ini);
+    }
+    plano.dataStatus = temStatus ? status : maiorData;
+    return true;
+}
+
+// ---------------- sessão interativa (grafo residente) ----------------
+// Plano de um arquivo no formato digitado (o mesmo leitor da entrada padrão, sem os
+// pedidos) ou de um grafo.json gravado antes. Em caso de falha, o motivo fica em 'erro'.
+bool lerPlanoArquivo(const string& caminho, Plano& plano, string& erro) {
+    ifstream f(caminho, ios::binary);
+    if (!f) {
+        erro = "não foi possível abrir " + caminho;
+        return false;
+    }
+    if ((f >> ws).peek() == '{') {
+        Cronograma c;
+        if (!lerCronogramaJSON(caminho, c)) {
+            erro = caminho + ": grafo.json inválido";
+            return false;
+        }
+        size_t n = c.rotulos.size();
+        plano.rotulos.reserve(n);
+        plano.dur.assign(n, 0);
+        for (size_t i = 0; i < n; i++) {
+            if (!(c.dur[i] >= 0)) {
+                erro = caminho + ": duração inválida de " + string(c.rotulos[i]);
+                return false;
+            }
+            plano.rotulos.push_back(c.rotulos[i]);
+            plano.dur[i] = is_integral_v<DuracaoEntrada> ? (DuracaoEntrada)llround(c.dur[i]) : (DuracaoEntrada)c.dur[i];
+        }
+        // arestas agrupadas pelo destino: predecessores de cada atividade
+        plano.predInicio.assign(n + 1, 0);
+        for (auto& a : c.arestas) plano.predInicio[a.second + 1]++;
+        for (size_t i = 0; i < n; i++) plano.predInicio[i + 1] += plano.predInicio[i];
+        plano.predAlvo.resize(c.arestas.size());
+        Vetor<uint64_t> pos(plano.predInicio.begin(), plano.predInicio.end() - 1, plano.predAlvo.get_allocator());
+        for (auto& a : c.arestas) plano.predAlvo[pos[a.second]++] = a.first;
+        return true;
+    }
+    IndiceRotulos indice(plano.rotulos);
+    if (!lerPlanoTexto(f, plano, false, indice, erro)) {
+        erro = caminho + ": " + erro;
+        return false;
+    }
+    return true;
+}
+
+// Grafo e cronograma residentes entre comandos, sobre o motor da execução normal:
+// Grafo com ListaDinamica, ES/EF/LS/LF em vetores por slot e os passos por vértice
+// de EspacoCPM. Carregar faz as duas passadas completas; cada alteração depois disso
+// recalcula só o que depende dela. ES/EF seguem para frente, em ordem topológica
+// (OrdemDinamica), a partir do que mudou. LS/LF ficam relativos ao fim do projeto
+// (passo de volta com duração 0): LS = -(caminho mais longo do início da atividade ao
+// fim), que não depende da duração D do projeto. Assim D mudar não toca nenhum
+// vértice; os valores de calcularPERT saem na consulta somando D. D é o maior EF:
+// sobe junto com a propagação e só é refeito por varredura quando um EF que o
+// atingia diminui.
+// Com um arquivo de progresso (comando progresso, ou --progresso junto de
+// --observar), exportar reprograma a partir das datas reais com um ReprogramacaoCPM
+// mantido entre as vezes: enquanto o grafo não muda e o progresso só avança, só as
+// atividades com novidade passam por iniciar/concluir e o cálculo percorre só as
+// não concluídas.
+// janela/instante consultam um IndiceIntervalos das janelas [ES, LF) que acompanha as
+// alterações: as atividades recalculadas desde a consulta anterior são reindexadas
+// (atualizarJanelas); só quando D muda, e com ele todo LF, o índice é refeito.
+// comparar monta o instantâneo do estado atual em memória e o compara, como --base,
+// com um grafo.json ou, sem arquivo, com o último exportado (guardado em 'gravado').
+//
+// Comandos, um por linha ('#' comenta):
+//   carregar ARQ            atividade ROTULO DURACAO   duracao ROTULO DURACAO
+//   ligar DE PARA           desligar DE PARA           remover ROTULO
+//   mostrar ROTULO          critico                    exportar
+//   simular ROTULO DURACAO [ROTULO DURACAO ...]        progresso [ARQ [DATA] | -]
+//   janela INICIO FIM       instante T                 comparar [ARQ]
+//   estado   ajuda   sair
+class SessaoCPM {
+public:
+    using Tempo = DuracaoEntrada;
+    using GrafoSessao = Grafo<uint32_t, ListaDinamica<uint32_t>>;
+
+    bool carregada() const { return !sequencia.empty(); }
+
+    // Executa um comando; false em "sair". Erros vão para cerr e a sessão continua.
+    bool processar(string_view linha) {
+        separarCampos(linha, campos);
+        if (campos.empty()) return true;
+        string_view cmd = campos[0];
+        size_t n = campos.size();
+        uint32_t a, b;
+        Tempo t{};
+        const char* erro = nullptr;
+        recalculadas = 0;
+        if (cmd == "sair" && n == 1) return false;
+        else if (cmd == "carregar" && n == 2) erro = carregar(string(campos[1]));
+        else if (cmd == "atividade" && n == 3) erro = !lerNumero(campos[2], t) ? "duração inválida" : novaAtividade(campos[1], t);
+        else if (cmd == "duracao" && n == 3)
+            erro = !achar(campos[1], a) ? "rótulo inexistente" : !lerNumero(campos[2], t) ? "duração inválida" : (mudarDuracao(a, t), nullptr);
+        else if ((cmd == "ligar" || cmd == "desligar") && n == 3)
+            erro = !achar(campos[1], a) || !achar(campos[2], b) ? "rótulo inexistente" : cmd == "ligar" ? ligar(a, b) : desligar(a, b);
+        else if (cmd == "remover" && n == 2) erro = !achar(campos[1], a) ? "rótulo inexistente" : (remover(a), nullptr);
+        else if (cmd == "mostrar" && n == 2) erro = !achar(campos[1], a) ? "rótulo inexistente" : (mostrar(a), nullptr);
+        else if (cmd == "simular" && n >= 3 && n % 2 == 1) erro = simular();
+        else if (cmd == "critico" && n == 1) imprimirCritico();
+        else if (cmd == "exportar" && n == 1) erro = exportar();
+        else if (cmd == "comparar" && n <= 2) erro = comparar();
+        else if (cmd == "progresso" && n <= 3) erro = progresso();
+        else if ((cmd == "janela" && n == 3) || (cmd == "instante" && n == 2)) erro = consultarJanela(n == 2);
+        else if (cmd == "estado" && n == 1) imprimirEstado();
+        else if (cmd == "ajuda" && n == 1) imprimirAjuda();
+        else erro = "comando inválido (ajuda lista os comandos)";
+        if (erro) cerr << "Erro: " << erro << ": " << linha << "\n";
+        return true;
+    }
+
+    void imprimirEstado() const {
+        cout << "Sessão: " << sequencia.size() << " atividade(s), " << g.suc.arestas()
+             << " aresta(s); duração do projeto " << duracao << "\n";
+    }
+
+    static void imprimirAjuda() {
+        cout << "Comandos:\n"
+             << "  carregar ARQ              plano digitado (ou grafo.json) de um arquivo\n"
+             << "  atividade ROTULO DURACAO  nova atividade sem predecessores\n"
+             << "  duracao ROTULO DURACAO    muda a duração\n"
+             << "  ligar DE PARA             nova dependência (recusada se fechar ciclo)\n"
+             << "  desligar DE PARA          remove a dependência\n"
+             << "  remover ROTULO            remove a atividade e suas dependências\n"
+             << "  mostrar ROTULO            datas, folga e vizinhos\n"
+             << "  critico                   duração do projeto e caminho crítico\n"
+             << "  simular ROTULO DURACAO ...\n"
+             << "                            e se: efeito das durações, depois desfeitas\n"
+             << "  exportar                  grava grafo.json (e grafo.delta.json)\n"
+             << "  comparar [ARQ]            compara o cronograma atual com um grafo.json de base;\n"
+             << "                            sem ARQ, com o último exportado na sessão\n"
+             << "  progresso [ARQ [DATA]]    datas reais (formato de --progresso, DATA = data de\n"
+             << "                            status); sem ARQ, relê o último; exportar reprograma\n"
+             << "  progresso -               volta ao cronograma planejado\n"
+             << "  janela INICIO FIM         atividades com janela [ES, LF) que toca [INICIO, FIM)\n"
+             << "  instante T                atividades com janela que contém T\n"
+             << "  estado | ajuda | sair\n";
+    }
+
+    // Relê 'arq': na primeira vez carrega tudo; depois aplica só a diferença para o
+    // grafo residente. Retorna true se algo mudou (e o cronograma foi atualizado).
+    bool atualizar(const string& arq) {
+        if (sequencia.empty()) {
+            const char* erro = carregar(arq);
+            if (erro) cerr << "Erro: " << erro << "\n";
+            return !erro && !sequencia.empty();
+        }
+        rascunho.reiniciar();
+        Plano plano(&rascunho);
+        string msg;
+        if (!lerPlanoArquivo(arq, plano, msg)) {
+            cerr << "Erro: " << msg << " (mantido o cronograma anterior)\n";
+            return false;
+        }
+        return sincronizar(plano);
+    }
+
+    // Progresso de --progresso (com --data-status) para --observar: vale a partir do
+    // próximo exportar/reprogramar.
+    void usarProgresso(const string& arq, bool temStatus, Tempo status) {
+        arqProgresso = arq;
+        temDataStatus = temStatus;
+        dataStatus = status;
+    }
+
+    // Relê o arquivo de progresso e reprograma (nada a fazer sem ele). Enquanto o grafo
+    // não muda e o arquivo só avança, reaproveita o que 'reprogramacao' já tem; senão
+    // prepara de novo sobre o grafo residente, com os slots livres (sem arestas) como
+    // concluídas em 0, que não limitam nada. Retorna o motivo da falha, ou nullptr.
+    const char* reprogramar() {
+        if (arqProgresso.empty()) return nullptr;
+        rascunho.reiniciar();
+        Plano plano(&rascunho);
+        listar(plano);
+        if (!lerProgresso(arqProgresso, temDataStatus, dataStatus, plano, msgErro)) return msgErro.c_str();
+        using Rep = ReprogramacaoCPM<uint32_t, Tempo>;
+        size_t n = sequencia.size(), andamento = 0;
+        bool reaproveitou = progressoPronto;
+        for (size_t i = 0; i < n && reaproveitou; i++)
+            reaproveitou = reprogramacao.avanca(sequencia[i], (Rep::Situacao)plano.situacao[i], plano.inicioReal[i],
+                                                plano.fimReal[i]);
+        if (!reaproveitou) {
+            reprogramacao.preparar(g);
+            for (uint32_t v : livres) reprogramacao.concluir(g, v, Tempo{}, Tempo{});
+            progressoPronto = true;
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint32_t v = sequencia[i];
+            if (plano.situacao[i] == Rep::EM_ANDAMENTO) {
+                reprogramacao.iniciar(g, v, plano.inicioReal[i], plano.restante[i]);
+                andamento++;
+            }
+            if (plano.situacao[i] == Rep::CONCLUIDA) reprogramacao.concluir(g, v, plano.inicioReal[i], plano.fimReal[i]);
+        }
+        for (Vetor<Tempo>* x : {&pES, &pEF, &pLS, &pLF}) x->resize(g.qntV);
+        reprogramacao.calcular(g, Duracoes<Tempo>(dur), plano.dataStatus, pES, pEF, pLS, pLF, duracaoProgresso);
+        cout << "Progresso: data de status " << plano.dataStatus << "; " << reprogramacao.quantidadeConcluidas() - livres.size()
+             << " concluída(s), " << andamento << " em andamento, " << reprogramacao.quantidadePendentes() - andamento
+             << " não iniciada(s); duração do projeto " << duracaoProgresso
+             << (reaproveitou ? " (reprogramação anterior reaproveitada)" : "") << "\n";
+        return nullptr;
+    }
+
+    // Mesmo grafo.json (versionado, com delta) da execução normal, a partir do estado
+    // atual (reprogramado, se houver progresso); depois do primeiro, a versão anterior
+    // para o delta já está em memória.
+    const char* exportar() {
+        if (const char* erro = reprogramar()) return erro;
+        gravar();
+        return nullptr;
+    }
+
+    // exportar sem reprogramar: usa as datas da última reprogramação.
+    void gravar() {
+        gravado = instantaneo(true);
+        temGravado = true;
+    }
+
+    // Estado atual (reprogramado, se houver progresso) contra o grafo.json 'campos[1]'
+    // ou, sem ele, contra o último exportado, sem gravar nada.
+    const char* comparar() {
+        Cronograma lido;
+        if (campos.size() == 2) {
+            msgErro = string(campos[1]);
+            if (!lerCronogramaJSON(msgErro, lido)) return (msgErro += ": grafo.json inválido").c_str();
+        } else if (!temGravado) {
+            return "nada exportado na sessão (comparar ARQ compara com um grafo.json)";
+        }
+        if (const char* erro = reprogramar()) return erro;
+        const Cronograma& base = campos.size() == 2 ? lido : gravado;
+        Cronograma atual = instantaneo(false);
+        atual.versao = gravado.versao + 1;   // a que o próximo exportar gravaria
+        imprimirComparacao(base, atual, compararCronogramas(base, atual));
+        return nullptr;
+    }
+
+private:
+    // Cronograma do estado atual, montado sobre um grafo CSR no rascunho; com 'gravar',
+    // sai também em grafo.json (e no delta contra 'gravado').
+    Cronograma instantaneo(bool gravar) {
+        rascunho.reiniciar();
+        Plano plano(&rascunho);
+        listar(plano);
+        size_t n = sequencia.size();
+        bool comProgresso = !arqProgresso.empty();
+        Grafo<uint32_t> gs(&rascunho);
+        construirGrafo(plano, gs);
+        Vetor<Tempo> d(plano.dur.begin(), plano.dur.end(), &rascunho), es(n, Tempo{}, &rascunho),
+            ef(n, Tempo{}, &rascunho), ls(n, Tempo{}, &rascunho), lf(n, Tempo{}, &rascunho);
+        for (size_t i = 0; i < n; i++) {
+            uint32_t v = sequencia[i];
+            es[i] = comProgresso ? pES[v] : ES[v];
+            ef[i] = comProgresso ? pEF[v] : EF[v];
+            ls[i] = comProgresso ? pLS[v] : duracao + LS[v];
+            lf[i] = comProgresso ? pLF[v] : duracao + LF[v];
+        }
+        Vetor<uint32_t> caminho = encontrarCaminhoCritico(gs, es, ef, ls, &rascunho);
+        SubgrafoCritico<uint32_t> sub = extrairSubgrafoCritico(gs, es, ef, ls, &rascunho);
+        Tempo D = comProgresso ? duracaoProgresso : duracao;
+        if (!gravar) return montarCronograma(gs, plano.rotulos, Duracoes<Tempo>(d), caminho, sub, es, ef, ls, lf, D);
+        return gravarVisualizacao(gs, plano.rotulos, Duracoes<Tempo>(d), caminho, sub, es, ef, ls, lf, D,
+                                  temGravado ? &gravado : nullptr);
+    }
+
+    struct No {
+        string rotulo;
+        bool naFila = false, livre = false, alterada = false;
+    };
+    // rótulos por slot, para imprimirJanela
+    struct RotulosSlots {
+        const vector<No>& nos;
+        string_view operator[](uint32_t v) const { return nos[v].rotulo; }
+    };
+
+    GrafoSessao g;
+    vector<No> nos;                      // por slot, como g e os vetores abaixo
+    Vetor<Tempo> dur, ES, EF, LS, LF;    // LS/LF relativos ao fim do projeto
+    EspacoCPM<uint32_t, Tempo> espaco;   // passadas completas de carregar
+    // Planos lidos ou listados e o grafo CSR de gravar: vivem só durante uma carga,
+    // releitura, reprogramação ou exportação, e cada uma começa com reiniciar(). Numa
+    // sessão longa, os blocos do maior plano visto ficam e o malloc sai do caminho.
+    Arena rascunho;
+    ReprogramacaoCPM<uint32_t, Tempo> reprogramacao;
+    bool progressoPronto = false;        // 'reprogramacao' preparada sobre o grafo atual
+    string arqProgresso;                 // vazio = cronograma planejado
+    bool temDataStatus = false;
+    Tempo dataStatus{}, duracaoProgresso{};
+    Vetor<Tempo> pES, pEF, pLS, pLF;     // datas reprogramadas, por slot
+    IndiceIntervalos<uint32_t, Tempo> janelas;
+    bool janelasProntas = false;
+    Tempo duracaoJanelas{};              // D quando o índice foi feito
+    Vetor<Tempo> lsJanela, lfJanela;     // LS/LF absolutos do índice
+    Vetor<uint32_t> alteradas;           // slots recalculados desde a última consulta
+    vector<uint32_t> achados;
+    string msgErro;                      // texto dos erros montados em tempo de execução
+    unordered_map<string, uint32_t> porRotulo;
+    OrdemDinamica ordem;
+    Cronograma gravado;                  // último grafo.json exportado: base do próximo delta
+    bool temGravado = false;
+    Tempo duracao{};
+    bool refazerDuracao = false;         // saiu uma atividade cujo EF era a duração
+    size_t recalculadas = 0;
+    vector<uint32_t> livres;             // slots de atividades removidas
+    vector<uint32_t> sequencia, posicao; // ordem de listagem (a do arquivo) e posição de cada slot nela
+    vector<uint32_t> marca;              // rascunho por slot, válido quando igual a 'epoca'
+    uint32_t epoca = 0;
+    vector<uint32_t> vizinhos;           // cópia de uma lista que vai ser alterada
+    vector<string_view> campos;
+    // para frente, menor posição primeiro; para trás, maior primeiro
+    priority_queue<pair<uint64_t, uint32_t>, vector<pair<uint64_t, uint32_t>>, greater<>> filaFrente;
+    priority_queue<pair<uint64_t, uint32_t>> filaTras;
+
+    bool achar(string_view rot, uint32_t& v) const {
+        auto it = porRotulo.find(string(rot));
+        if (it == porRotulo.end()) return false;
+        v = it->second;
+        return true;
+    }
+    Tempo inicioTarde(uint32_t v) const { return duracao + LS[v]; }
+    bool critica(uint32_t v) const { return semFolga(inicioTarde(v), ES[v]); }
+
+    void agendarFrente(uint32_t v) {
+        if (!nos[v].naFila) { nos[v].naFila = true; filaFrente.push({ordem[v], v}); }
+    }
+    void agendarTras(uint32_t v) { filaTras.push({ordem[v], v}); }
+    void marcarAlterada(uint32_t v) {
+        if (!nos[v].alterada) { nos[v].alterada = true; alteradas.push_back(v); }
+    }
+
+    // ES/EF dos agendados e, em ordem topológica, dos sucessores cujo EF mudou.
+    void propagarFrente() {
+        bool baixou = false;
+        Tempo maior = duracao;
+        Duracoes<Tempo> d(dur);
+        while (!filaFrente.empty()) {
+            uint32_t x = filaFrente.top().second;
+            filaFrente.pop();
+            nos[x].naFila = false;
+            if (nos[x].livre) continue;
+            recalculadas++;
+            marcarAlterada(x);
+            Tempo antes = EF[x];
+            Tempo ef = EspacoCPM<uint32_t, Tempo>::ida(g, x, d, ES, EF);
+            if (ef == antes) continue;
+            if (antes == duracao && ef < antes) baixou = true;
+            maior = max(maior, ef);
+            g.suc.paraCada(x, [&](uint32_t w) { agendarFrente(w); });
+        }
+        if (baixou || refazerDuracao) {
+            refazerDuracao = false;
+            duracao = Tempo{};
+            for (uint32_t v : sequencia) duracao = max(duracao, EF[v]);
+        } else {
+            duracao = maior;
+        }
+    }
+
+    // LS/LF relativos dos agendados e, em ordem topológica reversa, dos predecessores
+    // cujo LS mudou.
+    void propagarTras() {
+        uint32_t ultimo = UINT32_MAX;
+        Duracoes<Tempo> d(dur);
+        while (!filaTras.empty()) {
+            uint32_t x = filaTras.top().second;
+            filaTras.pop();
+            if (x == ultimo) continue;   // agendado mais de uma vez: posições iguais saem juntas
+            ultimo = x;
+            if (nos[x].livre) continue;
+            Tempo antes = LS[x];
+            EspacoCPM<uint32_t, Tempo>::volta(g, x, d, LS, LF, Tempo{});
+            if (LS[x] == antes) continue;
+            marcarAlterada(x);
+            g.pred.paraCada(x, [&](uint32_t p) { agendarTras(p); });
+        }
+    }
+
+    // Atividades na ordem de listagem, com durações e predecessores, como um plano lido.
+    void listar(Plano& plano) const {
+        size_t n = sequencia.size();
+        plano.rotulos.reserve(n);
+        plano.dur.resize(n);
+        plano.predInicio.assign(n + 1, 0);
+        plano.predAlvo.reserve(g.pred.arestas());
+        for (size_t i = 0; i < n; i++) {
+            uint32_t v = sequencia[i];
+            plano.rotulos.push_back(nos[v].rotulo);
+            plano.dur[i] = dur[v];
+            g.pred.paraCada(v, [&](uint32_t p) { plano.predAlvo.push_back(posicao[p]); });
+            plano.predInicio[i + 1] = plano.predAlvo.size();
+        }
+    }
+
+    const char* progresso() {
+        if (campos.size() == 2 && campos[1] == "-") {
+            arqProgresso.clear();
+            return nullptr;
+        }
+        if (campos.size() >= 2) {
+            Tempo t{};
+            if (campos.size() == 3 && !lerNumero(campos[2], t)) return "data de status inválida";
+            usarProgresso(string(campos[1]), campos.size() == 3, t);
+        }
+        if (arqProgresso.empty()) return "nenhum arquivo de progresso";
+        return reprogramar();
+    }
+
+    // Deixa o índice das janelas em dia: slots alterados são reindexados (os livres
+    // saem); com D diferente do da última vez, refaz tudo.
+    void sincronizarJanelas() {
+        size_t n = nos.size();
+        lsJanela.resize(n);
+        lfJanela.resize(n);
+        bool refazer = !janelasProntas || duracao != duracaoJanelas;
+        size_t k = 0;
+        for (uint32_t v : alteradas) {
+            nos[v].alterada = false;
+            if (nos[v].livre && !refazer) janelas.remover(v);
+            else if (!nos[v].livre) alteradas[k++] = v;
+        }
+        alteradas.resize(k);
+        if (refazer) {
+            for (size_t v = 0; v < n; v++) {
+                lsJanela[v] = duracao + LS[v];
+                lfJanela[v] = duracao + LF[v];
+            }
+            indexarJanelas(janelas, ES, lfJanela);
+            for (uint32_t v : livres) janelas.remover(v);
+            janelasProntas = true;
+            duracaoJanelas = duracao;
+        } else {
+            for (uint32_t v : alteradas) {
+                lsJanela[v] = duracao + LS[v];
+                lfJanela[v] = duracao + LF[v];
+            }
+            atualizarJanelas(janelas, alteradas, ES, lfJanela);
+        }
+        alteradas.clear();
+    }
+
+    // Atividades com janela [ES, LF) no intervalo ou no instante, no cronograma planejado.
+    const char* consultarJanela(bool instante) {
+        Tempo a{}, b{};
+        if (!lerNumero(campos[1], a)) return "início inválido";
+        if (instante) b = TempoTraits<Tempo>::proximo(a);
+        else if (!lerNumero(campos[2], b) || b <= a) return "fim inválido";
+        sincronizarJanelas();
+        achados.clear();
+        if (instante) janelas.perfurar(a, achados);
+        else janelas.consultar(a, b, achados);
+        imprimirJanela(achados, a, b, RotulosSlots{nos}, ES, EF, lsJanela, lfJanela);
+        return nullptr;
+    }
+
+    // Troca o grafo residente pelo plano de 'arq'; nullptr se deu certo, senão o motivo
+    // (a sessão anterior fica intacta).
+    const char* carregar(const string& arq) {
+        rascunho.reiniciar();
+        Plano plano(&rascunho);
+        if (!lerPlanoArquivo(arq, plano, msgErro)) return msgErro.c_str();
+        size_t n = plano.qntV();
+        if (n >= UINT32_MAX) return "plano grande demais para a sessão";
+        unordered_map<string, uint32_t> indice;
+        indice.reserve(n);
+        for (uint32_t v = 0; v < n; v++)
+            if (!indice.emplace(string(plano.rotulos[v]), v).second) return "rótulo repetido no plano";
+        GrafoSessao novo;
+        construirGrafo(plano, novo);
+        if (!espaco.preparar(novo)) return "o plano possui ciclo(s)";
+
+        g = move(novo);
+        progressoPronto = janelasProntas = false;
+        alteradas.clear();
+        porRotulo.swap(indice);
+        nos.assign(n, No{});
+        for (uint32_t v = 0; v < n; v++) nos[v].rotulo.assign(plano.rotulos[v]);
+        dur.assign(plano.dur.begin(), plano.dur.end());
+        for (Vetor<Tempo>* x : {&ES, &EF, &LS, &LF}) x->assign(n, Tempo{});
+        espaco.calcular(g, Duracoes<Tempo>(dur), ES, EF, LS, LF, duracao);
+        for (size_t v = 0; v < n; v++) {
+            LS[v] -= duracao;
+            LF[v] -= duracao;
+        }
+        livres.clear();
+        sequencia.resize(n);
+        iota(sequencia.begin(), sequencia.end(), 0u);
+        posicao = sequencia;
+        ordem.limpar();
+        for (uint32_t v : espaco.ordemTopologica()) ordem.novo(v);
+        cout << "Carregado: " << n << " atividade(s), " << g.suc.arestas() << " aresta(s); duração do projeto "
+             << duracao << "\n";
+        return nullptr;
+    }
+
+    // Atividade sem arestas no fim da listagem; UINT32_MAX se o rótulo já existe.
+    uint32_t criar(string_view rot, Tempo d) {
+        if (porRotulo.count(string(rot))) return UINT32_MAX;
+        uint32_t v;
+        if (!livres.empty()) {
+            v = livres.back();
+            livres.pop_back();
+        } else {
+            v = (uint32_t)nos.size();
+            nos.emplace_back();
+            posicao.push_back(0);
+            g.qntV = v + 1;
+            g.suc.redimensionar(g.qntV);
+            g.pred.redimensionar(g.qntV);
+            for (Vetor<Tempo>* x : {&dur, &ES, &EF, &LS, &LF}) x->push_back(Tempo{});
+        }
+        nos[v].rotulo.assign(rot);
+        nos[v].livre = false;
+        progressoPronto = false;
+        marcarAlterada(v);
+        dur[v] = EF[v] = d;
+        ES[v] = LF[v] = Tempo{};
+        LS[v] = -d;
+        porRotulo.emplace(nos[v].rotulo, v);
+        ordem.novo(v);
+        posicao[v] = (uint32_t)sequencia.size();
+        sequencia.push_back(v);
+        duracao = max(duracao, d);
+        return v;
+    }
+
+    const char* novaAtividade(string_view rot, Tempo d) {
+        if (nos.size() >= UINT32_MAX - 1 && livres.empty()) return "sessão cheia";
+        if (criar(rot, d) == UINT32_MAX) return "rótulo já existe";
+        imprimirResultado();
+        return nullptr;
+    }
+
+    // Tira v do grafo e agenda os vizinhos; o slot fica livre. Não mexe em 'sequencia'.
+    void desvincular(uint32_t v) {
+        g.pred.paraCada(v, [&](uint32_t p) {
+            g.suc.apagar(p, v);
+            agendarTras(p);
+        });
+        g.suc.paraCada(v, [&](uint32_t s) {
+            g.pred.apagar(s, v);
+            agendarFrente(s);
+        });
+        g.pred.esvaziar(v);
+        g.suc.esvaziar(v);
+        progressoPronto = false;
+        marcarAlterada(v);
+        if (EF[v] == duracao) refazerDuracao = true;
+        dur[v] = ES[v] = EF[v] = LS[v] = LF[v] = Tempo{};
+        nos[v].livre = true;
+        porRotulo.erase(nos[v].rotulo);
+        livres.push_back(v);
+    }
+
+    void remover(uint32_t v) {
+        desvincular(v);
+        sequencia.erase(sequencia.begin() + posicao[v]);
+        for (size_t i = posicao[v]; i < sequencia.size(); i++) posicao[sequencia[i]] = (uint32_t)i;
+        propagarFrente();
+        propagarTras();
+        imprimirResultado();
+    }
+
+    // Deixa o grafo residente igual ao plano 'p' mexendo só no que difere: atividades
+    // que saíram, que entraram ou mudaram de duração e arestas incluídas ou removidas.
+    // Aresta que fecharia ciclo é recusada e volta a ser tentada na próxima versão.
+    bool sincronizar(const Plano& p) {
+        size_t n = p.qntV();
+        unordered_map<string_view, uint32_t> noPlano;
+        noPlano.reserve(n);
+        for (size_t i = 0; i < n; i++)
+            if (!noPlano.emplace(p.rotulos[i], (uint32_t)i).second) {
+                cerr << "Erro: rótulo repetido no plano: " << p.rotulos[i] << " (mantido o cronograma anterior)\n";
+                return false;
+            }
+        recalculadas = 0;
+        size_t saiu = 0, entrou = 0, duracoes = 0, incluidas = 0, removidas = 0, recusadas = 0;
+        bool saiuAlguma = false;
+        for (uint32_t v : sequencia)
+            if (!noPlano.count(nos[v].rotulo)) {
+                desvincular(v);
+                saiu++;
+                saiuAlguma = true;
+            }
+        if (saiuAlguma) {   // slots liberados só são reaproveitados depois de propagar
+            sequencia.erase(remove_if(sequencia.begin(), sequencia.end(), [&](uint32_t v) { return nos[v].livre; }),
+                            sequencia.end());
+            propagarFrente();
+            propagarTras();
+        }
+
+        vector<uint32_t> slot(n);
+        for (size_t i = 0; i < n; i++) {
+            uint32_t v;
+            if (achar(p.rotulos[i], v)) {
+                if (dur[v] != p.dur[i]) {
+                    dur[v] = p.dur[i];
+                    agendarFrente(v);
+                    agendarTras(v);
+                    duracoes++;
+                }
+            } else {
+                v = criar(p.rotulos[i], p.dur[i]);
+                entrou++;
+            }
+            slot[i] = v;
+        }
+        marca.resize(nos.size(), 0);
+        auto novaEpoca = [&] {
+            if (++epoca == 0) {
+                fill(marca.begin(), marca.end(), 0);
+                epoca = 1;
+            }
+        };
+        // primeiro as remoções, para não recusar aresta por um ciclo que já saiu
+        for (size_t i = 0; i < n; i++) {
+            uint32_t v = slot[i];
+            novaEpoca();
+            for (uint64_t k = p.predInicio[i]; k < p.predInicio[i + 1]; k++) marca[slot[p.predAlvo[k]]] = epoca;
+            vizinhos.assign(g.pred[v].begin(), g.pred[v].end());
+            for (uint32_t u : vizinhos) {
+                if (marca[u] == epoca) continue;
+                g.pred.apagar(v, u);
+                g.suc.apagar(u, v);
+                progressoPronto = false;
+                agendarFrente(v);
+                agendarTras(u);
+                removidas++;
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint32_t v = slot[i];
+            novaEpoca();
+            g.pred.paraCada(v, [&](uint32_t u) { marca[u] = epoca; });
+            for (uint64_t k = p.predInicio[i]; k < p.predInicio[i + 1]; k++) {
+                uint32_t u = slot[p.predAlvo[k]];
+                if (marca[u] == epoca) continue;
+                marca[u] = epoca;
+                if (inserirAresta(u, v)) {
+                    incluidas++;
+                } else {
+                    cerr << "Aviso: aresta " << nos[u].rotulo << " -> " << nos[v].rotulo << " fecharia ciclo; ignorada\n";
+                    recusadas++;
+                }
+            }
+        }
+        propagarFrente();
+        propagarTras();
+        sequencia = slot;
+        for (size_t i = 0; i < n; i++) posicao[slot[i]] = (uint32_t)i;
+
+        bool mudou = saiu || entrou || duracoes || incluidas || removidas;
+        if (!mudou && !recusadas) return false;
+        cout << "Alterações: +" << entrou << "/-" << saiu << " atividade(s), " << duracoes << " duração(ões), +"
+             << incluidas << "/-" << removidas << " aresta(s)";
+        if (recusadas) cout << " (" << recusadas << " recusada(s))";
+        cout << "; " << recalculadas << " atividade(s) recalculada(s); duração do projeto " << duracao << "\n";
+        return mudou;
+    }
+
+    void mudarDuracao(uint32_t v, Tempo d) {
+        if (dur[v] == d) return imprimirResultado();
+        dur[v] = d;
+        agendarFrente(v);
+        agendarTras(v);
+        propagarFrente();
+        propagarTras();
+        imprimirResultado();
+    }
+
+    // u -> v nas listas e na ordem, com os extremos agendados; false se fecharia ciclo.
+    bool inserirAresta(uint32_t u, uint32_t v) {
+        if (u == v || !ordem.inserir(u, v, [&](uint32_t x) -> const Vetor<uint32_t>& { return g.suc[x]; },
+                                     [&](uint32_t x) -> const Vetor<uint32_t>& { return g.pred[x]; }))
+            return false;
+        g.suc.inserir(u, v);
+        g.pred.inserir(v, u);
+        progressoPronto = false;
+        agendarFrente(v);
+        agendarTras(u);
+        return true;
+    }
+
+    const char* ligar(uint32_t u, uint32_t v) {
+        if (u == v) return "aresta de uma atividade para ela mesma";
+        if (g.suc.contem(u, v)) return "aresta já existe";
+        if (!inserirAresta(u, v)) return "aresta fecharia ciclo";
+        propagarFrente();
+        propagarTras();
+        imprimirResultado();
+        return nullptr;
+    }
+
+    const char* desligar(uint32_t u, uint32_t v) {
+        if (!g.suc.apagar(u, v)) return "aresta inexistente";
+        g.pred.apagar(v, u);
+        progressoPronto = false;
+        agendarFrente(v);
+        agendarTras(u);
+        propagarFrente();
+        propagarTras();
+        imprimirResultado();
+        return nullptr;
+    }
+
+    void imprimirResultado() const {
+        cout << "Duração do projeto: " << duracao << " (" << recalculadas << " atividade(s) recalculada(s))\n";
+    }
+
+    // Aplica as durações, mostra o efeito e desfaz.
+    const char* simular() {
+        vector<pair<uint32_t, Tempo>> mudancas, originais;
+        for (size_t i = 1; i + 1 < campos.size(); i += 2) {
+            uint32_t v;
+            Tempo t;
+            if (!achar(campos[i], v)) return "rótulo inexistente";
+            if (!lerNumero(campos[i + 1], t)) return "duração inválida";
+            mudancas.push_back({v, t});
+        }
+        Tempo antes = duracao;
+        auto aplicar = [&](const vector<pair<uint32_t, Tempo>>& m) {
+            for (auto [v, t] : m) {
+                dur[v] = t;
+                agendarFrente(v);
+                agendarTras(v);
+            }
+            propagarFrente();
+            propagarTras();
+        };
+        for (auto [v, t] : mudancas) originais.push_back({v, dur[v]});
+        reverse(originais.begin(), originais.end());   // o mesmo rótulo duas vezes volta ao primeiro valor
+        aplicar(mudancas);
+        cout << "E se: duração do projeto " << antes << " -> " << duracao << " (" << recalculadas
+             << " atividade(s) recalculada(s))\n";
+        imprimirCaminho();
+        aplicar(originais);
+        return nullptr;
+    }
+
+    void mostrar(uint32_t v) const {
+        Tempo ls = inicioTarde(v);
+        cout << nos[v].rotulo << ": duração " << dur[v] << "; ES " << ES[v] << ", EF " << EF[v] << ", LS " << ls
+             << ", LF " << duracao + LF[v] << ", folga " << ls - ES[v] << (critica(v) ? " (crítica)" : "") << "\n";
+        auto lista = [&](const char* titulo, const Vetor<uint32_t>& l) {
+            cout << "  " << titulo << ":";
+            if (l.empty()) cout << " (nenhum)";
+            for (uint32_t w : l) cout << " " << nos[w].rotulo;
+            cout << "\n";
+        };
+        lista("predecessores", g.pred[v]);
+        lista("sucessores", g.suc[v]);
+    }
+
+    // Mesma regra de encontrarCaminhoCritico: começa pela primeira crítica sem
+    // predecessores (na falta, pela primeira crítica) e segue o sucessor crítico justo
+    // que vem antes na listagem, como nas listas ordenadas do grafo construído.
+    void imprimirCaminho() const {
+        uint32_t cur = UINT32_MAX;
+        for (uint32_t v : sequencia) if (g.pred.grau(v) == 0 && critica(v)) { cur = v; break; }
+        if (cur == UINT32_MAX)
+            for (uint32_t v : sequencia) if (critica(v)) { cur = v; break; }
+        EscritorBuffer out(stdout);
+        out << "Caminho crítico:";
+        if (cur == UINT32_MAX) out << " (nenhum)";
+        for (bool primeiro = true; cur != UINT32_MAX; primeiro = false) {
+            out << (primeiro ? " " : " -> ") << nos[cur].rotulo;
+            uint32_t prox = UINT32_MAX;
+            g.suc.paraCada(cur, [&](uint32_t w) {
+                if ((prox == UINT32_MAX || posicao[w] < posicao[prox]) && critica(w) && justa(EF[cur], ES[w])) prox = w;
+            });
+            cur = prox;
+        }
+        out << '\n';
+    }
+
+    void imprimirCritico() const {
+        size_t criticas = 0;
+        for (uint32_t v : sequencia) criticas += critica(v);
+        cout << "Duração do projeto: " << duracao << "; " << criticas << " atividade(s) crítica(s)\n";
+        imprimirCaminho();
+    }
+};
+
+// Lê comandos de 'in' até "sair" ou o fim; com terminal, mostra um prompt.
+int executarSessao(istream& in) {
+    cout << "=== PERT/CPM (sessão) ===\n";
+    bool terminal = isatty(STDIN_FILENO);
+    if (terminal) SessaoCPM::imprimirAjuda();
+    SessaoCPM sessao;
+    string linha;
+    while (true) {
+        if (terminal) cout << "> " << flush;
+        if (!getline(in, linha) || !sessao.processar(linha)) break;
+    }
+    sessao.imprimirEstado();
+    return 0;
+}
+
+// Observa 'arq' com inotify no diretório (pega também editores que gravam num
+// temporário e renomeiam): a cada gravação, só a diferença para o grafo residente
+// passa pelo recálculo e grafo.json é regravado de forma atômica. Com 'progresso'
+// (--progresso, e a data de status se 'temStatus'), o arquivo de progresso é
+// observado do mesmo jeito e reaplicado a cada releitura. 'consulta' (janela ou
+// instante, como na sessão) roda depois de cada atualização, sobre o índice de
+// janelas mantido pela sessão. Não retorna até ser interrompido, salvo erro do inotify.
+int executarObservacao(const string& arq, const string& progresso, bool temStatus, DuracaoEntrada status,
+                       const string& consulta) {
+    cout << "=== PERT/CPM (observando " << arq << ") ===\n";
+    int fd = inotify_init1(IN_CLOEXEC);
+    // diretório observado e nome do arquivo dentro dele
+    auto observar = [&](const string& caminho, int& wd, string& nome) {
+        size_t barra = caminho.rfind('/');
+        string dir = barra == string::npos ? "." : caminho.substr(0, barra + 1);
+        nome = barra == string::npos ? caminho : caminho.substr(barra + 1);
+        wd = fd < 0 ? -1 : inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) cerr << "Erro: inotify em " << dir << ": " << strerror(errno) << "\n";
+        return wd >= 0;
+    };
+    int wdPlano, wdProgresso = -1;
+    string nomePlano, nomeProgresso;
+    if (!observar(arq, wdPlano, nomePlano) || (!progresso.empty() && !observar(progresso, wdProgresso, nomeProgresso))) {
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+    SessaoCPM sessao;
+    if (!progresso.empty()) sessao.usarProgresso(progresso, temStatus, status);
+    auto atualizar = [&](bool progressoMudou) {
+        using Relogio = chrono::steady_clock;
+        auto ms = [](Relogio::duration d) { return chrono::duration<double, milli>(d).count(); };
+        Relogio::time_point t0 = Relogio::now();
+        bool mudou = sessao.atualizar(arq);
+        if (mudou || (progressoMudou && sessao.carregada())) {
+            if (const char* erro = sessao.reprogramar()) {
+                cerr << "Erro: " << erro << " (grafo.json não regravado)\n";
+            } else {
+                Relogio::time_point t1 = Relogio::now();
+                sessao.gravar();
+                printf("Atualizado em %.1f ms (leitura e recálculo %.1f ms, gravação %.1f ms)\n",
+                       ms(Relogio::now() - t0), ms(t1 - t0), ms(Relogio::now() - t1));
+                if (!consulta.empty()) sessao.processar(consulta);
+            }
+        }
+        cout << flush;
+    };
+    atualizar(false);
+    alignas(inotify_event) char buf[4096];
+    while (true) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            cerr << "Erro: inotify: " << strerror(errno) << "\n";
+            close(fd);
+            return 1;
+        }
+        bool plano = false, prog = false;
+        auto olhar = [&](char* ini, char* fim) {
+            for (char* p = ini; p < fim;) {
+                inotify_event* ev = (inotify_event*)p;
+                if (ev->len && ev->wd == wdPlano && nomePlano == ev->name) plano = true;
+                if (ev->len && ev->wd == wdProgresso && nomeProgresso == ev->name) prog = true;
+                p += sizeof(inotify_event) + ev->len;
+            }
+        };
+        olhar(buf, buf + n);
+        if (!plano && !prog) continue;
+        // editores gravam em etapas: relê depois de 50 ms sem novos eventos
+        pollfd pf{fd, POLLIN, 0};
+        while (poll(&pf, 1, 50) > 0 && (n = read(fd, buf, sizeof(buf))) > 0) olhar(buf, buf + n);
+        atualizar(prog);
+    }
+}
+
+// ---------------- opções de linha de comando ----------------
+constexpr size_t LIMITE_MATRIZ = 64;   // acima disso a matriz não cabe numa tela
+struct Opcoes {
+    string arqDot, arqGraphML;
+    string arqBase;                 // compara o cronograma calculado com esta base
+    string cmpBase, cmpAtual;       // --comparar: só compara dois arquivos
+    bool temJanela = false;         // consulta de janela de tempo [janelaIni, janelaFim)
+    bool instante = false;          // --instante: janela [T, proximo(T)) no tipo de tempo escolhido
+    double janelaIni = 0, janelaFim = 0;
+    bool comprimido = false;        // listas em delta + group-varint em vez de CSR
+    size_t memExterna = 0;          // --externo: orçamento em bytes para as arestas (0 = em memória)
+    bool rotulosCompactos = false;  // codificação por prefixo dos rótulos depois da leitura
+    Posicionamento posicionamento;  // páginas grandes / primeiro toque nos blocos da arena
+    bool numa = false;              // threads de paraleloBlocos fixadas por nó NUMA
+    size_t trabalhadores = 0;       // --distribuido / --coordenador: partes em processos trabalhadores
+    bool trabalhadoresLocais = false;   // --distribuido: criados com fork nesta máquina
+    uint16_t porta = 0;             // --coordenador: porta onde os trabalhadores conectam
+    string coordHost, coordPorta;   // --trabalhador: atende um coordenador e sai
+    uint64_t unidades = 1;          // --repetir: atividades digitadas são o modelo de uma unidade
+    struct LigacaoTexto {
+        string origem, destino;
+        uint64_t defasagem;
+    };
+    vector<LigacaoTexto> ligacoes;  // --ligacao, resolvidas depois da leitura dos rótulos
+    string ninjaLog, ninjaGrafo, ninjaDeps;   // plano importado de um build Ninja em vez de digitado
+    string trace;                   // plano reconstruído de um trace de execução
+    bool online = false;            // --online: eventos de DAGs em fluxo pela entrada padrão
+    bool sessao = false;            // --sessao: comandos sobre um grafo residente
+    string observar;                // --observar: recalcula a cada gravação do arquivo do plano
+    string progresso;               // datas reais e restantes; reprograma só o que não concluiu
+    bool temDataStatus = false;
+    double dataStatus = 0;          // --data-status; sem ela, a maior data real do progresso
+    string custos;                  // custo e recurso por atividade, para as curvas S
+    double periodoCurva = 0;        // --curva-s: tamanho do período (0 = sem curvas)
+    string recursos;                // capacidades e uso de recursos renováveis por atividade
+    MetodoPulmao ccpm = MetodoPulmao::NENHUM;   // --ccpm: corrente crítica com pulmões
+    string modos;                   // modos alternativos por atividade (multimodo)
+    size_t iteracoes = 64;          // --iteracoes: amostras da heurística multimodo
+    double janelaOnline = 0;        // DAG concluído há mais que isso sai da memória
+    bool matriz = false;            // --matriz: imprime a matriz de adjacência (só para V pequeno)
+    Ordenacao ordenacao;            // coluna da tabela; padrão: ordem de entrada
+    size_t pagina = 1, linhasPagina = 50;
+    vector<pair<Ordenacao, size_t>> topos;   // --top N CRITERIO, na ordem dada
+
+    bool importaNinja() const { return !ninjaLog.empty() || !ninjaGrafo.empty() || !ninjaDeps.empty(); }
+};
+
+void mostrarUso(const char* prog) {
+    cerr << "Uso: " << prog << " [opções]\n"
+         << "  --dot ARQ       exporta o grafo em DOT (Graphviz)\n"
+         << "  --graphml ARQ   exporta o grafo em GraphML (Gephi, yEd)\n"
+         << "  --base ARQ      compara o cronograma calculado com um grafo.json de base\n"
+         << "  --comparar BASE ATUAL\n"
+         << "                  compara dois grafo.json e sai, sem ler atividades\n"
+         << "  --janela INI FIM\n"
+         << "                  lista atividades com janela [ES, LF) tocando [INI, FIM)\n"
+         << "  --instante T    lista atividades com janela [ES, LF) contendo T\n"
+         << "  --comprimido    guarda as listas de adjacência em delta + group-varint\n"
+         << "  --externo MB    grava as arestas em disco já na leitura e calcula ES/EF/LS/LF com até MB\n"
+         << "                  de memória para elas (tabela, críticas, --top e --janela; sem caminho\n"
+         << "                  crítico, grafo.json nem exportações)\n"
+         << "  --rotulos-compactos\n"
+         << "                  guarda os rótulos com codificação por prefixo (IDs hierárquicos ordenados)\n"
+         << "  --paginas-grandes transparentes|explicitas\n"
+         << "                  blocos grandes da arena com madvise(MADV_HUGEPAGE) ou MAP_HUGETLB\n"
+         << "  --primeiro-toque\n"
+         << "                  páginas dos blocos grandes tocadas em paralelo pelas threads que as processam\n"
+         << "  --numa          primeiro toque com as threads fixadas por nó NUMA\n"
+         << "  --distribuido N calcula ES/EF/LS/LF em N processos trabalhadores locais\n"
+         << "  --coordenador PORTA N\n"
+         << "                  idem, com N trabalhadores que conectam em PORTA (outras máquinas)\n"
+         << "  --trabalhador HOST PORTA\n"
+         << "                  atende o coordenador em HOST:PORTA e sai\n"
+         << "  --repetir K     as atividades digitadas são o modelo de uma unidade, repetido K vezes\n"
+         << "                  (rede implícita, rótulos ROTULO@unidade)\n"
+         << "  --ligacao ORIG DEST DEF\n"
+         << "                  com --repetir: DEST da unidade u + DEF depende de ORIG da unidade u (DEF >= 1)\n"
+         << "  --ninja-log ARQ    durações de um .ninja_log (v5), em ms\n"
+         << "  --ninja-grafo ARQ  arestas da saída de 'ninja -t graph'\n"
+         << "  --ninja-deps ARQ   dependências da saída de 'ninja -t deps'\n"
+         << "                  com qualquer --ninja-*, o plano vem do build em vez de ser digitado\n"
+         << "  --trace ARQ     plano executado de um trace-event JSON (Chrome) ou log de spans JSON,\n"
+         << "                  com o caminho crítico realizado e as folgas nas durações medidas\n"
+         << "  --sessao        sessão de comandos (carregar, duracao, ligar, desligar, mostrar, critico,\n"
+         << "                  simular, progresso, exportar, comparar) com o grafo residente e recálculo\n"
+         << "                  incremental\n"
+         << "  --observar ARQ  recalcula a cada gravação de ARQ (plano digitado ou grafo.json) só o que\n"
+         << "                  mudou, regravando grafo.json de forma atômica; com --progresso, reprograma\n"
+         << "                  também a cada gravação do arquivo de progresso; com --janela/--instante,\n"
+         << "                  repete a consulta a cada atualização\n"
+         << "  --online JANELA lê eventos (atividade, aresta, inicio, fim, caminho, estado) em fluxo,\n"
+         << "                  descartando DAGs concluídos há mais de JANELA\n"
+         << "  --progresso ARQ linhas 'ROTULO concluida INICIO FIM' ou 'ROTULO andamento INICIO RESTANTE|P%':\n"
+         << "                  reprograma a partir da data de status só o que não concluiu\n"
+         << "  --data-status D data de status (padrão: a maior data real do progresso)\n"
+         << "  --custos ARQ    linhas 'ROTULO CUSTO [RECURSO]' (padrão: custo = duração, recurso 1)\n"
+         << "  --curva-s P     curvas S cedo/tarde de custo e recurso em períodos de P, em curva_s.csv\n"
+         << "  --recursos ARQ  linhas 'recurso NOME CAPACIDADE', 'consumivel NOME TOTAL' e\n"
+         << "                  'ROTULO NOME QTD [NOME QTD ...]'\n"
+         << "  --ccpm raiz|corte\n"
+         << "                  corrente crítica nivelada pelos recursos, com pulmões de projeto e de\n"
+         << "                  alimentação pela raiz da soma dos quadrados ou por corte e cola; em ccpm.csv\n"
+         << "  --modos ARQ     linhas 'ROTULO DURACAO [NOME QTD ...]', uma por modo: escolhe o modo de cada\n"
+         << "                  atividade junto com o escalonamento (recursos de --recursos), em multimodo.csv\n"
+         << "  --iteracoes N   amostras da heurística multimodo (padrão 64)\n"
+         << "  --matriz        imprime a matriz de adjacência (até " << LIMITE_MATRIZ << " vértices)\n"
+         << "  --pagina M      imprime a página M da tabela (padrão 1)\n"
+         << "  --linhas N      linhas por página da tabela e da lista de críticas (padrão 50)\n"
+         << "  --ordenar COL   ordena a tabela por atv, dur, es, ef, ls, lf, folga ou grau ('-COL' decrescente)\n"
+         << "  --top N CRIT    as N atividades de menor folga, maior duracao ou maior grau (sucessores);\n"
+         << "                  pode repetir\n";
+}
+
+bool lerOpcoes(int argc, char** argv, Opcoes& op) {
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        auto valor = [&](string& destino) {
+            if (i + 1 >= argc) return false;
+            destino = argv[++i];
+            return true;
+        };
+        if (a == "--dot") { if (!valor(op.arqDot)) return false; }
+        else if (a == "--graphml") { if (!valor(op.arqGraphML)) return false; }
+        else if (a == "--base") { if (!valor(op.arqBase)) return false; }
+        else if (a == "--comprimido") op.comprimido = true;
+        else if (a == "--ninja-log") { if (!valor(op.ninjaLog)) return false; }
+        else if (a == "--ninja-grafo") { if (!valor(op.ninjaGrafo)) return false; }
+        else if (a == "--ninja-deps") { if (!valor(op.ninjaDeps)) return false; }
+        else if (a == "--trace") { if (!valor(op.trace)) return false; }
+        else if (a == "--progresso") { if (!valor(op.progresso)) return false; }
+        else if (a == "--custos") { if (!valor(op.custos)) return false; }
+        else if (a == "--recursos") { if (!valor(op.recursos)) return false; }
+        else if (a == "--modos") { if (!valor(op.modos)) return false; }
+        else if (a == "--ccpm") {
+            string x;
+            if (!valor(x)) return false;
+            if (x == "raiz") op.ccpm = MetodoPulmao::RAIZ;
+            else if (x == "corte") op.ccpm = MetodoPulmao::CORTE;
+            else return false;
+        }
+        else if (a == "--curva-s") {
+            string x;
+            if (!valor(x)) return false;
+            try {
+                op.periodoCurva = stod(x);
+            } catch (const exception&) {
+                return false;
+            }
+            if (!(op.periodoCurva > 0)) return false;
+        }
+        else if (a == "--data-status") {
+            string x;
+            if (!valor(x)) return false;
+            try {
+                op.dataStatus = stod(x);
+            } catch (const exception&) {
+                return false;
+            }
+            if (!(op.dataStatus >= 0)) return false;
+            op.temDataStatus = true;
+        }
+        else if (a == "--online") {
+            string x;
+            if (!valor(x)) return false;
+            try {
+                op.janelaOnline = stod(x);
+            } catch (const exception&) {
+                return false;
+            }
+            if (!(op.janelaOnline >= 0)) return false;
+            op.online = true;
+        }
+        else if (a == "--matriz") op.matriz = true;
+        else if (a == "--sessao") op.sessao = true;
+        else if (a == "--observar") { if (!valor(op.observar)) return false; }
+        else if (a == "--ordenar") {
+            string x;
+            if (!valor(x) || !lerOrdenacao(x, op.ordenacao)) return false;
+        }
+        else if (a == "--pagina" || a == "--linhas" || a == "--top" || a == "--iteracoes") {
+            string x, c;
+            if (!valor(x)) return false;
+            if (a == "--top" && !valor(c)) return false;
+            try {
+                long long k = stoll(x);
+                if (k < 1) return false;
+                if (a == "--pagina") op.pagina = (size_t)k;
+                else if (a == "--linhas") op.linhasPagina = (size_t)k;
+                else if (a == "--iteracoes") op.iteracoes = (size_t)k;
+                else {
+                    Ordenacao o;
+                    if (!lerCriterioTopo(c, o)) return false;
+                    op.topos.push_back({o, (size_t)k});
+                }
+            } catch (const exception&) {
+                return false;
+            }
+        }
+        else if (a == "--rotulos-compactos") op.rotulosCompactos = true;
+        else if (a == "--primeiro-toque") op.posicionamento.primeiroToque = true;
+        else if (a == "--numa") op.posicionamento.primeiroToque = op.numa = true;
+        else if (a == "--paginas-grandes") {
+            string x;
+            if (!valor(x)) return false;
+            if (x == "transparentes") op.posicionamento.paginas = Posicionamento::TRANSPARENTES;
+            else if (x == "explicitas") op.posicionamento.paginas = Posicionamento::EXPLICITAS;
+            else return false;
+        }
+        else if (a == "--externo") {
+            string x;
+            if (!valor(x)) return false;
+            try {
+                double mb = stod(x);
+                if (!(mb > 0)) return false;
+                op.memExterna = (size_t)(mb * 1024 * 1024);
+            } catch (const exception&) {
+                return false;
+            }
+        }
+        else if (a == "--distribuido" || a == "--coordenador") {
+            string p, x;
+            if (a == "--coordenador" && !valor(p)) return false;
+            if (!valor(x)) return false;
+            try {
+                long long t = stoll(x), q = p.empty() ? 0 : stoll(p);
+                if (t <= 0 || t > 65536 || q < 0 || q > 65535) return false;
+                op.trabalhadores = (size_t)t;
+                op.porta = (uint16_t)q;
+            } catch (const exception&) {
+                return false;
+            }
+            op.trabalhadoresLocais = (a == "--distribuido");
+        }
+        else if (a == "--repetir" || a == "--ligacao") {
+            string o, d, x;
+            if (a == "--ligacao" && (!valor(o) || !valor(d))) return false;
+            if (!valor(x)) return false;
+            try {
+                long long k = stoll(x);
+                if (k < 1) return false;
+                if (a == "--repetir") op.unidades = (uint64_t)k;
+                else op.ligacoes.push_back({o, d, (uint64_t)k});
+            } catch (const exception&) {
+                return false;
+            }
+        }
+        else if (a == "--trabalhador") { if (!valor(op.coordHost) || !valor(op.coordPorta)) return false; }
+        else if (a == "--comparar") { if (!valor(op.cmpBase) || !valor(op.cmpAtual)) return false; }
+        else if (a == "--janela" || a == "--instante") {
+            string x, y;
+            if (!valor(x)) return false;
+            if (a == "--janela" && !valor(y)) return false;
+            try {
+                op.janelaIni = stod(x);
+                op.janelaFim = (a == "--janela") ? stod(y) : op.janelaIni;
+            } catch (const exception&) {
+                return false;
+            }
+            op.instante = (a == "--instante");
+            if (!op.instante && op.janelaFim <= op.janelaIni) return false;
+            op.temJanela = true;
+        }
+        else return false;
+    }
+    if (op.importaNinja() && !op.trace.empty()) return false;
+    // ligação é entre unidades: sem --repetir K > 1 não haveria onde aplicá-la
+    if (!op.ligacoes.empty() && op.unidades < 2) return false;
+    // o progresso é por atividade digitada e só o cálculo em memória sabe reprogramar
+    if (!op.progresso.empty() && (op.memExterna || op.trabalhadores || op.unidades > 1)) return false;
+    // --externo não monta listas: nada que percorra arestas depois do cálculo
+    if (op.memExterna && (op.importaNinja() || !op.trace.empty() || op.unidades > 1 || op.trabalhadores ||
+                          op.comprimido || op.matriz || !op.arqDot.empty() || !op.arqGraphML.empty() ||
+                          !op.arqBase.empty() || !op.custos.empty() || op.periodoCurva > 0 || !op.recursos.empty() ||
+                          op.ccpm != MetodoPulmao::NENHUM || !op.modos.empty()))
+        return false;
+    // a corrente crítica nivela a partir do zero, sem datas reais
+    if (op.ccpm != MetodoPulmao::NENHUM && !op.progresso.empty()) return false;
+    // os modos são por atividade digitada, escalonados a partir do zero
+    if (!op.modos.empty() && (!op.progresso.empty() || op.unidades > 1)) return false;
+    return true;
+}
+
+// Plano a partir dos arquivos do Ninja indicados nas opções.
+bool importarNinja(const Opcoes& op, Plano& plano) {
+    ImportadorNinja imp(plano.dur.get_allocator().resource());
+    auto ler = [&](const string& arq, bool (ImportadorNinja::*f)(const string&)) {
+        if (arq.empty() || (imp.*f)(arq)) return true;
+        cerr << "Erro ao ler " << arq << ".\n";
+        return false;
+    };
+    if (!ler(op.ninjaLog, &ImportadorNinja::lerLog) || !ler(op.ninjaGrafo, &ImportadorNinja::lerGrafo) ||
+        !ler(op.ninjaDeps, &ImportadorNinja::lerDeps))
+        return false;
+    imp.concluir(plano);
+    const EstatNinja& e = imp.estatisticas();
+    if (plano.qntV() == 0) {
+        cerr << "Erro: nenhum alvo encontrado nos arquivos do Ninja.\n";
+        return false;
+    }
+    cout << "=== PERT/CPM (build Ninja) ===\n\n"
+         << "Importados: " << e.arquivos << " arquivo(s), " << e.passos << " passo(s) com várias entradas/saídas, "
+         << e.arestas << " aresta(s), " << e.registrosLog << " registro(s) de log";
+    if (e.semDuracao) cout << "; " << e.semDuracao << " alvo(s) sem duração no log (0 ms)";
+    if (e.renomeados) cout << "; " << e.renomeados << " passo(s) com '#N' no rótulo, que repetia outro";
+    cout << "\nDurações em ms.\n";
+    return true;
+}
+
+// Plano executado a partir do trace indicado nas opções.
+bool importarTrace(const Opcoes& op, Plano& plano) {
+    ImportadorTrace imp(plano);
+    if (!imp.ler(op.trace)) {
+        cerr << "Erro ao ler " << op.trace << " (JSON inválido?).\n";
+        return false;
+    }
+    imp.concluir();
+    const EstatTrace& e = imp.estatisticas();
+    if (plano.qntV() == 0) {
+        cerr << "Erro: nenhum span com início e fim em " << op.trace << ".\n";
+        return false;
+    }
+    cout << "=== PERT/CPM (trace de execução) ===\n\n"
+         << "Importados: " << e.eventos << " evento(s), " << e.spans << " span(s), " << e.arestas << " aresta(s)";
+    if (e.arestasFluxo) cout << " (" << e.arestasFluxo << " de fluxos)";
+    if (e.depsSemSpan) cout << "; " << e.depsSemSpan << " dependência(s) sem span";
+    if (e.aninhados) cout << "; " << e.aninhados << " parent(s) aninhado(s) ignorado(s)";
+    if (e.abertos) cout << "; " << e.abertos << " span(s) sem fim, fechado(s) no fim do trace";
+    if (e.contrariadas) cout << "; " << e.contrariadas << " aresta(s) contrariada(s) pelos tempos";
+    cout << "\nDuração observada: " << ImportadorTrace::duracao(e.fim - e.inicio)
+         << " (do primeiro início ao último fim)\n";
+    const Vetor<uint64_t>& cam = imp.realizado();
+    cout << "Caminho realizado: ";
+    for (size_t i = 0; i < cam.size(); i++) cout << (i ? " -> " : "") << plano.rotulos[cam[i]];
+    cout << "\n  " << cam.size() << " span(s): " << ImportadorTrace::duracao(imp.execucaoRealizada())
+         << " em execução, " << ImportadorTrace::duracao(imp.esperaRealizada()) << " em espera\n"
+         << "Durações na unidade do trace (µs no formato do Chrome).\n";
+    return true;
+}
+
+// ---------------- custos, recursos e modos ----------------
+// Linhas "ROTULO CUSTO [RECURSO]" ('#' comenta); as atividades fora do arquivo ficam
+// com custo 0 e recurso 0. Chamar antes de compactar os rótulos.
+bool lerCustos(const Opcoes& op, Plano& plano) {
+    ifstream f(op.custos);
+    if (!f) {
+        cerr << "Erro ao ler " << op.custos << ".\n";
+        return false;
+    }
+    plano.custo.assign(plano.qntV(), 0);
+    plano.recurso.assign(plano.qntV(), 0);
+    IndiceRotulos indice(plano.rotulos);
+    string linha;
+    for (size_t num = 1; getline(f, linha); num++) {
+        size_t c = linha.find('#');
+        istringstream in(linha.substr(0, c));
+        string rot;
+        double custo, recurso = 0;
+        if (!(in >> rot)) continue;
+        int64_t i = indice.buscar(rot);
+        if (i < 0 || !(in >> custo) || custo < 0 || (!(in >> recurso) && !in.eof()) || recurso < 0) {
+            cerr << "Erro: " << op.custos << ":" << num << ": esperado 'ROTULO CUSTO [RECURSO]' com rótulo existente.\n";
+            return false;
+        }
+        plano.custo[i] = custo;
+        plano.recurso[i] = recurso;
+    }
+    return true;
+}
+
+// Recursos ('#' comenta):
+//   recurso NOME CAPACIDADE             (renovável: equipe, máquina)
+//   consumivel NOME TOTAL               (não renovável: verba, material do projeto todo)
+//   ROTULO NOME QTD [NOME QTD ...]      (ocupados enquanto a atividade executa, ou consumidos)
+// O recurso é declarado antes do uso; usos repetidos da mesma atividade se somam, e
+// passar da capacidade ou do total é erro (a atividade nunca caberia). Chamar antes de
+// compactar os rótulos.
+using NomesRecursos = unordered_map<string, pair<bool, uint32_t>>;   // nome -> (consumível, índice)
+
+NomesRecursos nomesRecursos(const Plano& plano) {
+    NomesRecursos porNome;
+    for (size_t r = 0; r < plano.nomesRecursos.size(); r++) porNome[plano.nomesRecursos[r]] = {false, (uint32_t)r};
+    for (size_t r = 0; r < plano.nomesConsumiveis.size(); r++) porNome[plano.nomesConsumiveis[r]] = {true, (uint32_t)r};
+    return porNome;
+}
+
+// Pares "NOME QTD" até o fim de 'in', guardados com 'chave' (atividade ou modo) em usos
+// ou consumos; retorna a mensagem de erro, ou nullptr.
+const char* lerUsos(istringstream& in, const NomesRecursos& porNome, uint64_t chave,
+                    vector<pair<uint64_t, UsoRecurso>>& usos, vector<pair<uint64_t, UsoRecurso>>& consumos) {
+    string nome;
+    long long q;
+    while (in >> nome) {
+        auto it = porNome.find(nome);
+        if (it == porNome.end()) return "recurso não declarado";
+        if (!(in >> q) || q < 0) return "quantidade inválida";
+        (it->second.first ? consumos : usos).push_back({chave, {it->second.second, q}});
+    }
+    return in.eof() ? nullptr : "esperado 'NOME QTD'";
+}
+
+// CSR por chave (0 .. n-1) dos pares lidos, somando repetidos do mesmo recurso. Retorna
+// a posição em 'lista' do primeiro que passa do seu limite, ou -1.
+int64_t montarUsos(vector<pair<uint64_t, UsoRecurso>>& lidos, size_t n, const Vetor<int64_t>& limite,
+                   Vetor<uint64_t>& inicio, Vetor<UsoRecurso>& lista) {
+    sort(lidos.begin(), lidos.end(), [](auto& x, auto& y) {
+        return x.first != y.first ? x.first < y.first : x.second.recurso < y.second.recurso;
+    });
+    inicio.assign(n + 1, 0);
+    lista.clear();
+    int64_t excedido = -1;
+    for (size_t k = 0; k < lidos.size(); k++) {
+        auto [i, u] = lidos[k];
+        if (k && lidos[k - 1].first == i && lista.back().recurso == u.recurso) lista.back().quantidade += u.quantidade;
+        else {
+            lista.push_back(u);
+            inicio[i + 1]++;
+        }
+        if (excedido < 0 && lista.back().quantidade > limite[lista.back().recurso]) excedido = (int64_t)lista.size() - 1;
+    }
+    for (size_t i = 0; i < n; i++) inicio[i + 1] += inicio[i];
+    return excedido;
+}
+
+bool lerRecursos(const Opcoes& op, Plano& plano) {
+    ifstream f(op.recursos);
+    if (!f) {
+        cerr << "Erro ao ler " << op.recursos << ".\n";
+        return false;
+    }
+    IndiceRotulos indice(plano.rotulos);
+    NomesRecursos porNome;
+    vector<pair<uint64_t, UsoRecurso>> usos, consumos;
+    string linha;
+    for (size_t num = 1; getline(f, linha); num++) {
+        size_t c = linha.find('#');
+        istringstream in(linha.substr(0, c));
+        string rot, nome;
+        long long q;
+        if (!(in >> rot)) continue;
+        auto erro = [&](const char* msg) {
+            cerr << "Erro: " << op.recursos << ":" << num << ": " << msg << ".\n";
+            return false;
+        };
+        if (rot == "recurso" || rot == "consumivel") {
+            bool consumivel = rot == "consumivel";
+            if (!(in >> nome >> q) || q < 0 || !(in >> ws).eof()) return erro("esperado 'recurso|consumivel NOME QTD'");
+            vector<string>& nomes = consumivel ? plano.nomesConsumiveis : plano.nomesRecursos;
+            if (!porNome.emplace(nome, make_pair(consumivel, (uint32_t)nomes.size())).second) return erro("recurso repetido");
+            nomes.push_back(nome);
+            (consumivel ? plano.totalConsumivel : plano.capacidade).push_back(q);
+            continue;
+        }
+        int64_t i = indice.buscar(rot);
+        if (i < 0) return erro("rótulo inexistente");
+        size_t antes = usos.size() + consumos.size();
+        if (const char* msg = lerUsos(in, porNome, (uint64_t)i, usos, consumos)) return erro(msg);
+        if (usos.size() + consumos.size() == antes) return erro("esperado 'ROTULO NOME QTD [NOME QTD ...]'");
+    }
+    // rótulo do dono de cada posição, para a mensagem de excesso
+    auto dono = [&](const Vetor<uint64_t>& inicio, int64_t k) {
+        return plano.rotulos[upper_bound(inicio.begin(), inicio.end(), (uint64_t)k) - inicio.begin() - 1];
+    };
+    int64_t k = montarUsos(usos, plano.qntV(), plano.capacidade, plano.usoInicio, plano.usos);
+    if (k >= 0) {
+        const UsoRecurso& u = plano.usos[k];
+        cerr << "Erro: " << op.recursos << ": " << dono(plano.usoInicio, k) << " usa " << u.quantidade << " de "
+             << plano.nomesRecursos[u.recurso] << ", acima da capacidade " << plano.capacidade[u.recurso] << ".\n";
+        return false;
+    }
+    k = montarUsos(consumos, plano.qntV(), plano.totalConsumivel, plano.consumoInicio, plano.consumos);
+    if (k >= 0) {
+        const UsoRecurso& u = plano.consumos[k];
+        cerr << "Erro: " << op.recursos << ": " << dono(plano.consumoInicio, k) << " consome " << u.quantidade << " de "
+             << plano.nomesConsumiveis[u.recurso] << ", acima do total " << plano.totalConsumivel[u.recurso] << ".\n";
+        return false;
+    }
+    return true;
+}
+
+// Modos alternativos ('#' comenta), um por linha:
+//   ROTULO DURACAO [NOME QTD ...]
+// com os recursos de --recursos. A atividade com linhas aqui executa num desses modos,
+// na ordem do arquivo (os usos dela em --recursos não valem); as demais ficam com um
+// modo só, a duração digitada e os usos de --recursos. Chamar depois de lerRecursos e
+// antes de compactar os rótulos.
+bool lerModos(const Opcoes& op, Plano& plano) {
+    ifstream f(op.modos);
+    if (!f) {
+        cerr << "Erro ao ler " << op.modos << ".\n";
+        return false;
+    }
+    size_t n = plano.qntV();
+    IndiceRotulos indice(plano.rotulos);
+    NomesRecursos porNome = nomesRecursos(plano);
+    vector<pair<uint64_t, DuracaoEntrada>> lidos;   // (atividade, duração) por linha
+    vector<pair<uint64_t, UsoRecurso>> usos, consumos;   // chave: linha de 'lidos'
+    string linha;
+    for (size_t num = 1; getline(f, linha); num++) {
+        size_t c = linha.find('#');
+        istringstream in(linha.substr(0, c));
+        string rot;
+        DuracaoEntrada d;
+        if (!(in >> rot)) continue;
+        auto erro = [&](const char* msg) {
+            cerr << "Erro: " << op.modos << ":" << num << ": " << msg << ".\n";
+            return false;
+        };
+        int64_t i = indice.buscar(rot);
+        if (i < 0) return erro("rótulo inexistente");
+        if (!(in >> d) || d < 0) return erro("esperado 'ROTULO DURACAO [NOME QTD ...]'");
+        if (const char* msg = lerUsos(in, porNome, lidos.size(), usos, consumos)) return erro(msg);
+        lidos.push_back({(uint64_t)i, d});
+    }
+
+    // linhas agrupadas por atividade; quem não tem linha ganha o modo digitado
+    vector<uint64_t> ordem(lidos.size());
+    iota(ordem.begin(), ordem.end(), 0);
+    stable_sort(ordem.begin(), ordem.end(), [&](uint64_t x, uint64_t y) { return lidos[x].first < lidos[y].first; });
+    vector<uint64_t> novo(lidos.size());
+    plano.modoInicio.assign(n + 1, 0);
+    plano.modoDur.clear();
+    for (size_t a = 0, p = 0; a < n; a++) {
+        if (p < ordem.size() && lidos[ordem[p]].first == a) {
+            for (; p < ordem.size() && lidos[ordem[p]].first == a; p++) {
+                novo[ordem[p]] = plano.modoDur.size();
+                plano.modoDur.push_back(lidos[ordem[p]].second);
+            }
+        } else {
+            uint64_t k = plano.modoDur.size();
+            plano.modoDur.push_back(plano.dur[a]);
+            if (plano.temRecursos())
+                for (uint64_t j = plano.usoInicio[a]; j < plano.usoInicio[a + 1]; j++) usos.push_back({~k, plano.usos[j]});
+            if (!plano.consumoInicio.empty())
+                for (uint64_t j = plano.consumoInicio[a]; j < plano.consumoInicio[a + 1]; j++)
+                    consumos.push_back({~k, plano.consumos[j]});
+        }
+        plano.modoInicio[a + 1] = plano.modoDur.size();
+    }
+    // chaves: linha do arquivo, ou ~modo para os copiados de --recursos
+    for (auto* v : {&usos, &consumos})
+        for (auto& [chave, u] : *v) chave = (chave >> 63) ? ~chave : novo[chave];
+    size_t M = plano.modoDur.size();
+    // modo (1 = primeiro da atividade) e rótulo do dono de cada posição, para a mensagem de excesso
+    auto dono = [](const Vetor<uint64_t>& v, uint64_t x) { return (uint64_t)(upper_bound(v.begin(), v.end(), x) - v.begin() - 1); };
+    auto excesso = [&](const Vetor<uint64_t>& inicio, int64_t k) -> ostream& {
+        uint64_t m = dono(inicio, k), a = dono(plano.modoInicio, m);
+        return cerr << "Erro: " << op.modos << ": o modo " << m - plano.modoInicio[a] + 1 << " de " << plano.rotulos[a];
+    };
+    int64_t k = montarUsos(usos, M, plano.capacidade, plano.modoUsoInicio, plano.modoUsos);
+    if (k >= 0) {
+        const UsoRecurso& u = plano.modoUsos[k];
+        excesso(plano.modoUsoInicio, k) << " usa " << u.quantidade << " de " << plano.nomesRecursos[u.recurso]
+                                        << ", acima da capacidade " << plano.capacidade[u.recurso] << ".\n";
+        return false;
+    }
+    k = montarUsos(consumos, M, plano.totalConsumivel, plano.modoConsumoInicio, plano.modoConsumos);
+    if (k >= 0) {
+        const UsoRecurso& u = plano.modoConsumos[k];
+        excesso(plano.modoConsumoInicio, k) << " consome " << u.quantidade << " de " << plano.nomesConsumiveis[u.recurso]
+                                            << ", acima do total " << plano.totalConsumivel[u.recurso] << ".\n";
+        return false;
+    }
+    return true;
+}
+
+// ---------------- escolha dos tipos ----------------
+// Chama f(Idx{}, Tempo{}) com a menor instanciação que comporta o plano.
+// Índice: V precisa ficar abaixo de NENHUM e E caber nos deslocamentos.
+// Tempo: na família inteira, int32 enquanto a soma das durações (limite do
+// caminho mais longo) couber nele.
+template <class F>
+int despacharTipos(const Plano& p, F&& f) {
+    auto comTempo = [&](auto idx) {
+#if defined(CPM_TEMPO_FIXO) || defined(CPM_TEMPO_REAL)
+        return f(idx, TempoFracionario{});
+#else
+        int64_t soma = 0;
+        for (int64_t d : p.dur) {
+            if (d > INT64_MAX - soma) { cerr << "Erro: soma das durações excede int64.\n"; return 1; }
+            soma += d;
+        }
+        if (soma && p.unidades > (uint64_t)(INT64_MAX / soma)) { cerr << "Erro: soma das durações excede int64.\n"; return 1; }
+        soma *= (int64_t)p.unidades;
+        // com progresso, datas reais e restantes se somam ao que ainda não começou
+        int64_t base = p.dataStatus;
+        for (size_t i = 0; i < p.situacao.size(); i++) {
+            base = max({base, p.inicioReal[i], p.fimReal[i]});
+            if (p.restante[i] > INT64_MAX - soma) { cerr << "Erro: soma das durações excede int64.\n"; return 1; }
+            soma += p.restante[i];
+        }
+        if (base > INT64_MAX - soma) { cerr << "Erro: datas do progresso excedem int64.\n"; return 1; }
+        soma += base;
+        if (soma <= INT32_MAX) return f(idx, int32_t{});
+        return f(idx, int64_t{});
+#endif
+    };
+    uint64_t V = p.qntVExpandido(), E = p.qntEExpandido();
+    if (V < UINT16_MAX && E <= UINT32_MAX) return comTempo(uint16_t{});
+    if (V < UINT32_MAX && E <= UINT32_MAX) return comTempo(uint32_t{});
+    return comTempo(uint64_t{});
+}
+
+// ---------------- execução ----------------
+// Tabela (página e ordem de --pagina/--ordenar), duração e atividades críticas.
+template <class Idx, class Tempo, class Adj>
+void imprimirTabelaCriticas(const Relatorio<Idx, Tempo, Adj>& relatorio, const Rotulos& rotulos,
+                            const Vetor<Tempo>& folga, Tempo durProjeto, const Opcoes& op) {
+    char t[32];
+    EscritorBuffer out(stdout);
+    relatorio.imprimirTabela(out, op.ordenacao, op.pagina, op.linhasPagina);
+    out << "Duração mínima: " << textoTempo(durProjeto, t) << '\n';
+
+    out << "\nAtividades críticas (folga total = 0):\n";
+    size_t criticas = 0;
+    for (size_t i = 0; i < folga.size(); i++) if (TempoTraits<Tempo>::zero(folga[i])) {
+        if (criticas++ < op.linhasPagina) out << rotulos[i] << ' ';
+    }
+    if (criticas > op.linhasPagina) out << "... (" << criticas << " no total)";
+    if (!criticas) out << "(nenhuma)\n";
+    out << '\n';
+}
+
+// Consulta de --janela/--instante sobre as janelas [ES, LF).
+template <class Idx, class Tempo>
+void imprimirJanelaOpcoes(const Opcoes& op, const Rotulos& rotulos, const Vetor<Tempo>& ES, const Vetor<Tempo>& EF,
+                          const Vetor<Tempo>& LS, const Vetor<Tempo>& LF) {
+    Tempo a = TempoTraits<Tempo>::deReal(op.janelaIni);
+    Tempo b = op.instante ? TempoTraits<Tempo>::proximo(a) : TempoTraits<Tempo>::deReal(op.janelaFim);
+    IndiceIntervalos<Idx, Tempo> janelas;
+    indexarJanelas(janelas, ES, LF);
+    vector<Idx> achados;
+    if (op.instante) janelas.perfurar(a, achados);
+    else janelas.consultar(a, b, achados);
+    imprimirJanela(achados, a, b, rotulos, ES, EF, LS, LF);
+}
+
+template <class Idx, class Tempo, class Adj>
+int executar(const Plano& plano, const Opcoes& op, Arena& arena) {
+    Grafo<Idx, Adj> g(&arena);
+    construirGrafo(plano, g);
+    Idx n = g.qntV;
+    // rede repetida: rótulos "rótulo@unidade" e durações do modelo em cada unidade,
+    // montados a cada acesso a partir do par (atividade, unidade)
+    Rotulos repetidos(&arena);
+    if (plano.unidades > 1) {
+        repetidos = plano.rotulos;
+        repetidos.repetir(plano.unidades);
+        if (op.rotulosCompactos) repetidos.compactar();
+    }
+    const Rotulos& rotulos = plano.unidades > 1 ? repetidos : plano.rotulos;
+    Vetor<Tempo> durModelo(plano.qntV(), Tempo{}, &arena);
+    for (size_t a = 0; a < plano.qntV(); a++) durModelo[a] = TempoTraits<Tempo>::deReal((double)plano.dur[a]);
+    Duracoes<Tempo> dur(Faixa<const Tempo>(durModelo), plano.unidades);
+
+    char t[7][32];
+    cout << "\nTipos: índice " << nomeTipo<Idx>() << ", tempo " << nomeTipo<Tempo>() << "\n";
+    if (op.comprimido) {
+        uint64_t E = g.suc.arestas();
+        size_t bytes = g.suc.bytes() + g.pred.bytes();
+        cout << "Adjacência delta + group-varint: " << bytes << " bytes";
+        if (E) printf(" (%.2f bytes/aresta)", (double)bytes / (double)E);
+        cout << "\n";
+    }
+    if (plano.unidades > 1)
+        cout << "Rede repetida: " << plano.unidades << " unidade(s) de " << plano.qntV() << " atividade(s), "
+             << g.suc.arestas() << " arestas implícitas em " << g.suc.bytes() + g.pred.bytes() << " bytes\n";
+
+    // só a impressão é matricial; o cálculo usa as listas
+    if (op.matriz && n <= LIMITE_MATRIZ) {
+        EscritorBuffer out(stdout);
+        out << "\nGrafo construído. Matriz de adjacência:\n";
+        out << "   ";
+        for (Idx j = 0; j < n; j++) out << j << ' ';
+        out << '\n';
+        for (Idx i = 0; i < n; i++) {
+            out << i << ": ";
+            Idx j = 0;   // vizinhos chegam em ordem crescente
+            g.suc.paraCada(i, [&](Idx v) {
+                for (; j < v; j++) out << "0 ";
+                out << "1 ";
+                j = v + 1;
+            });
+            for (; j < n; j++) out << "0 ";
+            out << "   (" << rotulos[i] << ", d=" << textoTempo(dur[i], t[0]) << ")\n";
+        }
+    } else {
+        cout << "\nGrafo construído: " << n << " vértices, " << g.suc.arestas() << " arestas";
+        if (op.matriz) cout << " (matriz só até " << LIMITE_MATRIZ << " vértices)";
+        cout << ".\n";
+    }
+
+    Vetor<Tempo> ES(&arena), EF(&arena), LS(&arena), LF(&arena);
+    Tempo durProjeto{};
+    bool ok;
+    if (op.trabalhadores) {
+        vector<pid_t> filhos;
+        vector<Canal> trab = aceitarTrabalhadores(op.trabalhadores, op.porta, op.trabalhadoresLocais, filhos);
+        EstatDistribuido est;
+        bool erroRede = trab.size() != op.trabalhadores;
+        ok = !erroRede && calcularPERTDistribuido(g, dur, trab, ES, EF, LS, LF, durProjeto, est, erroRede);
+        trab.clear();   // fecha as conexões: trabalhadores ainda esperando saem
+        for (pid_t f : filhos) waitpid(f, nullptr, 0);
+        if (erroRede) {
+            cerr << "Erro de comunicação no modo distribuído.\n";
+            return 1;
+        }
+        // em stderr: a saída padrão fica igual à do cálculo local
+        fprintf(stderr, "Modo distribuído: %zu parte(s), %llu aresta(s) de corte, %zu rodada(s) de ordem, "
+                "%zu de ida, %zu de volta, %.1f KB trocados\n", est.partes, (unsigned long long)est.arestasCorte,
+                est.rodadasOrdem, est.rodadasIda, est.rodadasVolta, est.bytes / 1024.0);
+    } else if (plano.temProgresso()) {
+        ReprogramacaoCPM<Idx, Tempo> rep(&arena);
+        ok = rep.preparar(g);
+        auto T = [](DuracaoEntrada x) { return TempoTraits<Tempo>::deReal((double)x); };
+        size_t andamento = 0;
+        for (Idx i = 0; i < n && ok; i++) {
+            if (plano.situacao[i] == 1) { rep.iniciar(g, i, T(plano.inicioReal[i]), T(plano.restante[i])); andamento++; }
+            if (plano.situacao[i] == 2) rep.concluir(g, i, T(plano.inicioReal[i]), T(plano.fimReal[i]));
+        }
+        if (ok) {
+            ES.resize(n);
+            EF.resize(n);
+            LS.resize(n);
+            LF.resize(n);
+            rep.calcular(g, dur, T(plano.dataStatus), Faixa<Tempo>(ES), Faixa<Tempo>(EF),
+                         Faixa<Tempo>(LS), Faixa<Tempo>(LF), durProjeto);
+            printf("\nProgresso: data de status %s; %zu concluída(s), %zu em andamento, %zu não iniciada(s)\n",
+                   textoTempo(T(plano.dataStatus), t[0]), rep.quantidadeConcluidas(), andamento,
+                   rep.quantidadePendentes() - andamento);
+        }
+    } else {
+        ok = calcularPERT(g, dur, ES, EF, LS, LF, durProjeto);
+    }
+    if (op.posicionamento.ativo()) imprimirPosicionamento(arena);
+    if (!ok) {
+        cout << "\nErro: o grafo possui ciclo(s).\n";
+        return 0;
+    }
+
+    Vetor<Tempo> folga(n, Tempo{}, &arena);
+    for (Idx i = 0; i < n; i++) folga[i] = LS[i] - ES[i];
+
+    Relatorio<Idx, Tempo, Adj> relatorio(g, rotulos, dur, ES, EF, LS, LF, folga);
+    imprimirTabelaCriticas(relatorio, rotulos, folga, durProjeto, op);
+
+    Vetor<Idx> caminhoCrit = encontrarCaminhoCritico(g, ES, EF, LS, &arena);
+    if (!caminhoCrit.empty()) {
+        EscritorBuffer out(stdout);
+        out << "Caminho crítico: ";
+        for (size_t i = 0; i < caminhoCrit.size(); i++) {
+            if (i) out << " -> ";
+            out << rotulos[caminhoCrit[i]];
+        }
+        out << '\n';
+    } else {
+        cout << "Não foi possível extrair um caminho crítico linear.\n";
+    }
+
+    SubgrafoCritico<Idx> sub = extrairSubgrafoCritico(g, ES, EF, LS, &arena);
+    cout << "Subgrafo crítico: " << sub.nos.size() << " nós, " << sub.arestas.size() << " arestas, "
+         << sub.caminhos << " caminho(s) crítico(s).\n";
+    if (!op.topos.empty()) {
+        EscritorBuffer out(stdout);
+        for (auto& [o, k] : op.topos) relatorio.imprimirTopo(out, o, k);
+    }
+
+    Cronograma atual = gravarVisualizacao(g, rotulos, dur, caminhoCrit, sub, ES, EF, LS, LF, durProjeto);
+    if (op.temJanela) imprimirJanelaOpcoes<Idx>(op, rotulos, ES, EF, LS, LF);
+    if (!op.arqBase.empty()) {
+        Cronograma base;
+        if (lerCronogramaJSON(op.arqBase, base)) imprimirComparacao(base, atual, compararCronogramas(base, atual));
+        else cerr << "Aviso: não foi possível ler a base " << op.arqBase << ".\n";
+    }
+    if (!op.arqDot.empty() && gerarDOT(op.arqDot, g, rotulos, dur, ES, EF, LS, LF))
+        cout << "Arquivo '" << op.arqDot << "' gerado.\n";
+    if (!op.arqGraphML.empty() && gerarGraphML(op.arqGraphML, g, rotulos, dur, ES, EF, LS, LF))
+        cout << "Arquivo '" << op.arqGraphML << "' gerado.\n";
+    if (op.periodoCurva > 0) {
+        // rede repetida: custo e recurso do modelo em cada unidade
+        Vetor<double> custo(n, 0, &arena), recurso(n, 1, &arena);
+        for (Idx i = 0; i < n; i++) {
+            size_t a = i % plano.qntV();
+            custo[i] = plano.custo.empty() ? TempoTraits<Tempo>::real(dur[i]) : plano.custo[a];
+            if (!plano.recurso.empty()) recurso[i] = plano.recurso[a];
+        }
+        CurvasS cs = calcularCurvasS(Faixa<const Tempo>(ES), Faixa<const Tempo>(EF), Faixa<const Tempo>(LS),
+                                     Faixa<const Tempo>(LF), Faixa<const double>(custo), Faixa<const double>(recurso),
+                                     durProjeto, op.periodoCurva);
+        size_t picoCedo = 0, picoTarde = 0;
+        for (size_t k = 1; k < cs.periodos; k++) {
+            if (cs.recursoCedo[k + 1] - cs.recursoCedo[k] > cs.recursoCedo[picoCedo + 1] - cs.recursoCedo[picoCedo]) picoCedo = k;
+            if (cs.recursoTarde[k + 1] - cs.recursoTarde[k] > cs.recursoTarde[picoTarde + 1] - cs.recursoTarde[picoTarde]) picoTarde = k;
+        }
+        double p = cs.periodo;
+        printf("\nCurvas S: %zu período(s) de %g; custo total %.2f; pico de recurso %.3f no período %zu (cedo), "
+               "%.3f no período %zu (tarde)\n", cs.periodos, p, cs.custoCedo[cs.periodos],
+               (cs.recursoCedo[picoCedo + 1] - cs.recursoCedo[picoCedo]) / p, picoCedo + 1,
+               (cs.recursoTarde[picoTarde + 1] - cs.recursoTarde[picoTarde]) / p, picoTarde + 1);
+        if (gravarCurvasS("curva_s.csv", cs)) cout << "Arquivo 'curva_s.csv' gerado.\n";
+        else cerr << "Erro ao gravar curva_s.csv.\n";
+    }
+    if (op.ccpm != MetodoPulmao::NENHUM) {
+        // rede repetida: uso de recursos do modelo em cada unidade
+        const UsoRecurso* base = plano.usos.data();
+        auto uso = [&](Idx v) {
+            if (!plano.temRecursos()) return make_pair(base, base);
+            size_t a = v % plano.qntV();
+            return make_pair(base + plano.usoInicio[a], base + plano.usoInicio[a + 1]);
+        };
+        vector<int64_t> cap(plano.capacidade.begin(), plano.capacidade.end());
+        CorrenteCritica<Idx, Tempo> cc =
+            calcularCorrenteCritica(g, dur, Faixa<const Tempo>(LS), cap, uso, op.ccpm);
+        {
+            EscritorBuffer out(stdout);
+            out << "\nCorrente crítica";
+            if (plano.temRecursos()) out << " (nivelada por " << cap.size() << " recurso(s))";
+            out << ": ";
+            bool porRecurso = false;
+            for (size_t k = 0; k < cc.corrente.size(); k++) {
+                if (k) out << (cc.porRecurso[k] ? " ~> " : " -> ");
+                porRecurso |= cc.porRecurso[k] != 0;
+                out << rotulos[cc.corrente[k]];
+            }
+            if (porRecurso) out << "\n  ('~>' = ligação por recurso)";
+            out << "\nDuração nivelada: " << textoTempo(cc.duracaoNivelada, t[0]) << " (CPM " << textoTempo(durProjeto, t[1])
+                << "); pulmão de projeto " << textoTempo(cc.pulmaoProjeto, t[2])
+                << (op.ccpm == MetodoPulmao::RAIZ ? " (raiz da soma dos quadrados)" : " (corte e cola)")
+                << "; prazo com pulmão " << textoTempo(cc.duracaoNivelada + cc.pulmaoProjeto, t[3]) << '\n';
+            out << "Pulmões de alimentação: " << cc.alimentacao.size() << '\n';
+            size_t reduzidos = 0;
+            for (size_t k = 0; k < cc.alimentacao.size(); k++) {
+                auto& p = cc.alimentacao[k];
+                reduzidos += p.efetivo < p.tamanho;
+                if (k >= op.linhasPagina) continue;
+                out << "  " << rotulos[p.fim] << " -> "
+                    << (p.juncao == Grafo<Idx>::NENHUM ? string_view("(fim)") : rotulos[p.juncao]) << ": "
+                    << textoTempo(p.tamanho, t[0]) << ", efetivo " << textoTempo(p.efetivo, t[1]) << " (cadeia de "
+                    << p.atividades << " atividade(s))" << (p.efetivo < p.tamanho ? " reduzido" : "") << '\n';
+            }
+            if (cc.alimentacao.size() > op.linhasPagina) out << "  ... (" << cc.alimentacao.size() << " no total)\n";
+            if (reduzidos) out << reduzidos << " pulmão(ões) de alimentação reduzido(s) pela folga disponível\n";
+        }
+        if (gravarCCPM("ccpm.csv", cc, rotulos, dur)) cout << "Arquivo 'ccpm.csv' gerado.\n";
+        else cerr << "Erro ao gravar ccpm.csv.\n";
+    }
+    if (plano.temModos()) {
+        ResultadoMultimodo<Tempo> mm = resolverMultimodo<Idx, Tempo>(g, plano, op.iteracoes, &arena);
+        size_t variaveis = 0;
+        for (Idx v = 0; v < n; v++) variaveis += plano.modoInicio[v + 1] - plano.modoInicio[v] > 1;
+        EscritorBuffer out(stdout);
+        out << "\nMultimodo: " << plano.modoDur.size() << " modo(s), " << variaveis
+            << " atividade(s) com mais de um; limite inferior (CPM com o modo mais curto) "
+            << textoTempo(mm.limiteInferior, t[0]) << '\n';
+        if (mm.semTotal >= 0) {
+            out << "Inviável: o consumo mínimo de " << plano.nomesConsumiveis[mm.semTotal] << " passa do total "
+                << plano.totalConsumivel[mm.semTotal] << ".\n";
+        } else if (!mm.viavel) {
+            out << "Nenhuma das " << mm.executadas << " iteração(ões) respeitou os não renováveis ("
+                << mm.inviaveis << " sem modo viável).\n";
+        } else {
+            double lb = TempoTraits<Tempo>::real(mm.limiteInferior), d = TempoTraits<Tempo>::real(mm.duracao);
+            char pct[32];
+            snprintf(pct, sizeof pct, "%.1f", lb > 0 ? 100 * (d - lb) / lb : 0.0);
+            out << "Melhor: " << textoTempo(mm.duracao, t[0]) << " (+" << pct << "% sobre o limite) na iteração "
+                << mm.melhor << "; " << mm.executadas << " iteração(ões), " << mm.podadas << " podada(s) pelo limite, "
+                << mm.inviaveis << " sem modo viável" << (mm.duracao == mm.limiteInferior ? "; ótimo" : "") << '\n';
+            for (size_t r = 0; r < mm.consumo.size(); r++)
+                out << (r ? ", " : "Consumo: ") << plano.nomesConsumiveis[r] << ' ' << mm.consumo[r] << '/'
+                    << plano.totalConsumivel[r] << (r + 1 == mm.consumo.size() ? "\n" : "");
+            size_t mostradas = 0;
+            for (Idx v = 0; v < n && mostradas < op.linhasPagina; v++) {
+                if (plano.modoInicio[v + 1] - plano.modoInicio[v] < 2) continue;
+                out << (mostradas++ ? ", " : "Modos: ") << rotulos[v] << '=' << mm.modo[v] - plano.modoInicio[v] + 1;
+            }
+            if (variaveis > mostradas) out << ", ... (" << variaveis << " no total)";
+            if (mostradas) out << '\n';
+        }
+        out.fechar();
+        if (mm.viavel) {
+            if (gravarMultimodo("multimodo.csv", mm, plano, rotulos)) cout << "Arquivo 'multimodo.csv' gerado.\n";
+            else cerr << "Erro ao gravar multimodo.csv.\n";
+        }
+    }
+
+    return 0;
+}
+
+// Só os graus de saída, contados na leitura: no modo externo o relatório não vê listas.
+template <class Idx>
+struct GrausSaida {
+    Vetor<uint64_t> graus;
+    explicit GrausSaida(pmr::memory_resource* mem = pmr::get_default_resource()) : graus(mem) {}
+    uint64_t grau(Idx u) const { return graus[u]; }
+};
+
+// --externo: o plano chega sem listas (as arestas foram para 'arestas' durante a
+// leitura), então só sai o que depende dos vetores por atividade: tabela, críticas,
+// --top e --janela.
+template <class Idx, class Tempo>
+int executarExterno(const Plano& plano, const Opcoes& op, Arena& arena, FILE* arestas, uint64_t qntE,
+                    Vetor<uint64_t>& grauSuc) {
+    Idx n = (Idx)plano.qntV();
+    Vetor<Tempo> durV(n, Tempo{}, &arena);
+    for (Idx i = 0; i < n; i++) durV[i] = TempoTraits<Tempo>::deReal((double)plano.dur[i]);
+    Duracoes<Tempo> dur(durV);
+    cout << "\nTipos: índice " << nomeTipo<Idx>() << ", tempo " << nomeTipo<Tempo>() << "\n";
+    cout << "\nArestas gravadas em disco na leitura: " << n << " vértices, " << qntE << " arestas.\n";
+
+    Vetor<Tempo> ES(&arena), EF(&arena), LS(&arena), LF(&arena);
+    Tempo durProjeto{};
+    EstatExterno est;
+    bool erroES = false;
+    bool ok = calcularPERTExterno(arestas, n, dur, op.memExterna, ES, EF, LS, LF, durProjeto, est, erroES);
+    if (erroES) {
+        cerr << "Erro de E/S no modo externo.\n";
+        return 1;
+    }
+    printf("\nModo externo: %zu corrida(s), %zu nível(is), %.1f MB lidos, %.1f MB escritos\n",
+           est.corridas, est.niveis, est.lidos / 1048576.0, est.escritos / 1048576.0);
+    if (op.posicionamento.ativo()) imprimirPosicionamento(arena);
+    if (!ok) {
+        cout << "\nErro: o grafo possui ciclo(s).\n";
+        return 0;
+    }
+
+    Vetor<Tempo> folga(n, Tempo{}, &arena);
+    for (Idx i = 0; i < n; i++) folga[i] = LS[i] - ES[i];
+    Grafo<Idx, GrausSaida<Idx>> g(&arena);
+    g.qntV = n;
+    g.suc.graus = move(grauSuc);
+    Relatorio<Idx, Tempo, GrausSaida<Idx>> relatorio(g, plano.rotulos, dur, ES, EF, LS, LF, folga);
+    imprimirTabelaCriticas(relatorio, plano.rotulos, folga, durProjeto, op);
+    if (!op.topos.empty()) {
+        EscritorBuffer out(stdout);
+        for (auto& [o, k] : op.topos) relatorio.imprimirTopo(out, o, k);
+    }
+    if (op.temJanela) imprimirJanelaOpcoes<Idx>(op, plano.rotulos, ES, EF, LS, LF);
+    return 0;
+}
+
+// ---------------- leitura interativa ----------------
+// Atividades, durações e predecessores digitados; ligações de --repetir resolvidas
+// pelos rótulos. A lista de predecessores da atividade i (índices, talvez repetidos)
+// vai para predecessores(i, lista). Retorna false se a entrada terminar antes do
+// plano completo ou se uma ligação citar rótulo inexistente.
+template <class F>
+bool lerPlanoDigitado(Plano& plano, const Opcoes& op, F&& predecessores) {
+    cout << "=== PERT/CPM (vértices = atividades) ===\n\n";
+    IndiceRotulos indice(plano.rotulos);
+    string erro;
+    if (!lerPlanoTexto(cin, plano, true, indice, erro, predecessores)) {
+        cerr << "Erro: " << erro << ".\n";
+        return false;
+    }
+
+    plano.unidades = op.unidades;
+    for (const Opcoes::LigacaoTexto& l : op.ligacoes) {
+        int64_t o = indice.buscar(l.origem), d = indice.buscar(l.destino);
+        if (o < 0 || d < 0) {
+            cerr << "Erro: ligação " << l.origem << " -> " << l.destino << " cita rótulo inexistente.\n";
+            return false;
+        }
+        plano.ligacoes.push_back({(uint64_t)o, (uint64_t)d, l.defasagem});
+    }
+    return true;
+}
+
+// Listas guardadas no plano (predInicio/predAlvo), para construirGrafo.
+bool lerPlanoDigitado(Plano& plano, const Opcoes& op) {
+    plano.predInicio.assign(1, 0);
+    return lerPlanoDigitado(plano, op, [&](uint64_t, const Vetor<int64_t>& pl) {
+        plano.predAlvo.insert(plano.predAlvo.end(), pl.begin(), pl.end());
+        plano.predInicio.push_back(plano.predAlvo.size());
+    });
+}
+
+// ---------------- main ----------------
+int main(int argc, char** argv) {
+    Opcoes op;
+    if (!lerOpcoes(argc, argv, op)) {
+        mostrarUso(argv[0]);
+        return 1;
+    }
+
+    if (!op.coordHost.empty()) return executarTrabalhador(op.coordHost, op.coordPorta);
+
+    if (!op.cmpBase.empty()) {
+        Cronograma base, atual;
+        if (!lerCronogramaJSON(op.cmpBase, base)) { cerr << "Erro ao ler " << op.cmpBase << ".\n"; return 1; }
+        if (!lerCronogramaJSON(op.cmpAtual, atual)) { cerr << "Erro ao ler " << op.cmpAtual << ".\n"; return 1; }
+        imprimirComparacao(base, atual, compararCronogramas(base, atual));
+        return 0;
+    }
+
+    // sem arena: o fluxo não tem fim e a memória é reaproveitada slot a slot
+    if (op.online) return executarOnline(cin, (DuracaoEntrada)op.janelaOnline);
+    if (op.sessao) return executarSessao(cin);
+    if (!op.observar.empty()) {
+        ostringstream consulta;   // --janela/--instante viram o comando da sessão
+        if (op.temJanela) {
+            consulta << setprecision(17) << (op.instante ? "instante " : "janela ")
+                     << TempoTraits<DuracaoEntrada>::deReal(op.janelaIni);
+            if (!op.instante) consulta << ' ' << TempoTraits<DuracaoEntrada>::deReal(op.janelaFim);
+        }
+        return executarObservacao(op.observar, op.progresso, op.temDataStatus,
+                                  TempoTraits<DuracaoEntrada>::deReal(op.dataStatus), consulta.str());
+    }
+
+    // tudo o que depende do tamanho do plano mora na arena e é liberado de uma vez ao sair
+    TopologiaNUMA::instancia().fixarThreads = op.numa;
+    Arena arena(size_t(1) << 20, op.posicionamento);
+    Plano plano(&arena);
+    // --externo: cada lista de predecessores vai direto para o arquivo de arestas e o
+    // plano fica só com os vetores por atividade
+    unique_ptr<FILE, int (*)(FILE*)> arestas(nullptr, fclose);
+    uint64_t qntE = 0;
+    Vetor<uint64_t> grauSuc(&arena);
+    if (op.importaNinja()) {
+        if (!importarNinja(op, plano)) return 1;
+    } else if (op.memExterna) {
+        arestas.reset(tmpfile());
+        bool erroES = !arestas;
+        if (!erroES && !lerPlanoDigitado(plano, op, [&](uint64_t v, Vetor<int64_t>& pl) {
+                if (grauSuc.empty()) grauSuc.assign(plano.qntV(), 0);   // a quantidade já foi lida
+                sort(pl.begin(), pl.end());
+                pl.erase(unique(pl.begin(), pl.end()), pl.end());
+                for (int64_t u : pl) {
+                    ArestaArquivo a((uint64_t)u, v);
+                    if (fwrite(&a, sizeof(a), 1, arestas.get()) != 1) erroES = true;
+                    grauSuc[u]++;
+                }
+                qntE += pl.size();
+            }))
+            return 1;
+        if (erroES) {
+            cerr << "Erro de E/S no modo externo.\n";
+            return 1;
+        }
+    } else if (!op.trace.empty()) {
+        if (!importarTrace(op, plano)) return 1;
+    } else if (!lerPlanoDigitado(plano, op)) {
+        return 1;
+    }
+    string erro;
+    if (!op.progresso.empty() &&
+        !lerProgresso(op.progresso, op.temDataStatus, TempoTraits<DuracaoEntrada>::deReal(op.dataStatus), plano, erro)) {
+        cerr << "Erro: " << erro << ".\n";
+        return 1;
+    }
+    if (!op.custos.empty() && !lerCustos(op, plano)) return 1;
+    if (!op.recursos.empty() && !lerRecursos(op, plano)) return 1;
+    if (!op.modos.empty() && !lerModos(op, plano)) return 1;
+
+    // o índice de rótulos guarda views: só depois dele os rótulos podem ser compactados
+    if (op.rotulosCompactos) {
+        size_t antes = plano.rotulos.bytes();
+        bool comp = plano.rotulos.compactar();
+        cout << "\nRótulos: " << antes << " -> " << plano.rotulos.bytes() << " bytes"
+             << (comp ? " (codificação por prefixo)" : " (mantidos empacotados: prefixo não compensa)") << "\n";
+    }
+
+    return despacharTipos(plano, [&](auto idx, auto tempo) {
+        using Idx = decltype(idx);
+        if (arestas) return executarExterno<Idx, decltype(tempo)>(plano, op, arena, arestas.get(), qntE, grauSuc);
+        if (plano.unidades > 1) return executar<Idx, decltype(tempo), ListaRepetida<Idx>>(plano, op, arena);
+        if (op.comprimido) return executar<Idx, decltype(tempo), ListaComprimida<Idx>>(plano, op, arena);
+        return executar<Idx, decltype(tempo), ListaAdj<Idx>>(plano, op, arena);
+    });
 }